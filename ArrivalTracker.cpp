@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "ArrivalTracker.h"
+
+/*
+metodo: ArrivalTracker
+descripcion: Constructor, reserva las tablas de llegada (sin llegada = -1) y de máximos por nodo
+retorno: -
+*/
+ArrivalTracker::ArrivalTracker(int num_nodes, const std::vector<double>& thresholds)
+    :   umbrales(thresholds)
+{
+    std::sort(umbrales.begin(), umbrales.end());
+    kUmbrales = static_cast<int>(umbrales.size());
+    llegada.assign(static_cast<size_t>(num_nodes) * kUmbrales, -1);
+    siguiente.assign(num_nodes, 0);
+    pico.assign(num_nodes, 0.0);
+    paso_pico.assign(num_nodes, -1);
+}
+
+/*
+metodo: addNode
+descripcion: Agrega un nodo al final (sin llegadas), para seguir a la red cuando crece con Network::addNode
+retorno: -
+*/
+void ArrivalTracker::addNode(){
+    llegada.insert(llegada.end(), kUmbrales, -1);
+    siguiente.push_back(0);
+    pico.push_back(0.0);
+    paso_pico.push_back(-1);
+}
+
+/*
+metodo: observeAll
+descripcion: Registra un estado completo (por ejemplo el estado inicial, antes del primer paso)
+retorno: -
+*/
+void ArrivalTracker::observeAll(StateView A, int step){
+    const int n = static_cast<int>(std::min(A.size(), pico.size()));
+    for(int i = 0; i < n; ++i) update(i, A[i], step);
+}
+
+/*
+metodo: write
+descripcion: Escribe la tabla por nodo: paso de llegada a cada umbral (-1 si no llegó), amplitud máxima, su paso
+             y su tiempo
+retorno: -
+*/
+void ArrivalTracker::write(const std::string& path, double dt) const {
+    std::ofstream f(path);
+    if(!f.is_open()){
+        std::cerr << "No se pudo abrir " << path << std::endl;
+        return;
+    }
+    f << "# dt " << dt << " umbrales";
+    for(double u : umbrales) f << " " << u;
+    f << "\n# nodo";
+    for(int k = 0; k < kUmbrales; ++k) f << " llegada_" << k;
+    f << " pico paso_pico tiempo_pico\n";
+
+    const int n = static_cast<int>(pico.size());
+    for(int i = 0; i < n; ++i){
+        f << i;
+        for(int k = 0; k < kUmbrales; ++k) f << " " << arrivalStep(i, k);
+        f << " " << std::scientific << std::setprecision(6) << pico[i] << " " << paso_pico[i]
+          << " " << (paso_pico[i] >= 0 ? paso_pico[i] * dt : -1.0) << "\n";
+    }
+}
+
+/*
+metodo: parseThresholds
+descripcion: Convierte una lista "0.01,0.1" en un vector de umbrales. Lanza una excepción si algún valor no es un
+             número positivo finito o si la lista queda vacía
+retorno: vector con los umbrales
+*/
+std::vector<double> ArrivalTracker::parseThresholds(const std::string& lista){
+    std::vector<double> out;
+    std::stringstream ss(lista);
+    std::string tok;
+    while(std::getline(ss, tok, ',')){
+        if(tok.empty()) continue;
+        size_t fin = 0;
+        double u = 0.0;
+        try {
+            u = std::stod(tok, &fin);
+        } catch(const std::exception&){
+            fin = 0;
+        }
+        if(fin != tok.size() || !std::isfinite(u) || u <= 0.0){
+            throw std::runtime_error("Umbral de llegada invalido: " + tok);
+        }
+        out.push_back(u);
+    }
+    if(out.empty()) throw std::runtime_error("La lista de umbrales de llegada esta vacia");
+    return out;
+}
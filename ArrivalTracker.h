@@ -0,0 +1,60 @@
+#ifndef ARRIVALTRACKER_H
+#define ARRIVALTRACKER_H
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "StateView.h"
+
+/*
+Abstracción:
+Seguimiento in situ del frente de onda: por nodo se guarda el primer paso en que |A| alcanza cada umbral y la
+amplitud máxima con su paso. Se actualiza dentro del barrido del kernel (cada nodo lo escribe solo la hebra que
+lo calcula) y al final se escribe una tabla de N filas, en vez de guardar todos los cuadros
+*/
+
+class ArrivalTracker{
+public:
+    //Constructor: umbrales de |A| (se ordenan de menor a mayor)
+    ArrivalTracker(int num_nodes, const std::vector<double>& thresholds);
+
+    //getters
+    int getSize() const { return static_cast<int>(pico.size()); }
+    const std::vector<double>& getThresholds() const { return umbrales; }
+    int arrivalStep(int node, int k) const { return llegada[static_cast<size_t>(node) * umbrales.size() + k]; }
+    double peakAmplitude(int node) const { return pico[node]; }
+    int peakStep(int node) const { return paso_pico[node]; }
+
+    //otros metodos
+    //Registra el valor del nodo i en el paso dado. Como los umbrales están ordenados, solo se compara contra el
+    //siguiente umbral no alcanzado
+    inline void update(int i, double value, int step){
+        const double a = std::fabs(value);
+        if(a > pico[i]){
+            pico[i] = a;
+            paso_pico[i] = step;
+        }
+        int& k = siguiente[i];
+        while(k < kUmbrales && a >= umbrales[k]){
+            llegada[static_cast<size_t>(i) * kUmbrales + k] = step;
+            ++k;
+        }
+    }
+    void observeAll(StateView A, int step);
+    void addNode();
+    void write(const std::string& path, double dt) const;
+
+    static std::vector<double> parseThresholds(const std::string& lista);
+
+private:
+    //datos privados
+    std::vector<double> umbrales;
+    int kUmbrales;
+    std::vector<int> llegada;       // N x umbrales, -1 si nunca se alcanzó
+    std::vector<int> siguiente;     // índice del siguiente umbral no alcanzado por nodo
+    std::vector<double> pico;
+    std::vector<int> paso_pico;
+};
+
+#endif
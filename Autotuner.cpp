@@ -0,0 +1,179 @@
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <filesystem>
+#include <thread>
+#include <omp.h>
+
+#include "Autotuner.h"
+#include "Benchmark.h"
+#include "Network.h"
+#include "ExecutionPolicy.h"
+
+/*
+metodo: machineFingerprint
+descripcion: Genera una huella de la máquina a partir del modelo de CPU y la cantidad de procesadores,
+             para que las configuraciones guardadas no se reutilicen en otro hardware
+retorno: string con la huella en hexadecimal
+*/
+std::string Autotuner::machineFingerprint(){
+    std::string modelo = "desconocido";
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string linea;
+    while(std::getline(cpuinfo, linea)){
+        if(linea.rfind("model name", 0) == 0){
+            modelo = linea.substr(linea.find(':') + 1);
+            break;
+        }
+    }
+
+    std::ostringstream desc;
+    desc << modelo << "|" << omp_get_num_procs() << "|" << std::thread::hardware_concurrency();
+
+    std::ostringstream out;
+    out << std::hex << std::hash<std::string>{}(desc.str());
+    return out.str();
+}
+
+/*
+metodo: makeKey
+descripcion: Construye la llave de la topología, por ejemplo "1d-100", "2d-100x100" o "3d-64x64x64-p"
+             (el sufijo -p indica bordes periódicos)
+retorno: string con la llave
+*/
+std::string Autotuner::makeKey(int dimensions, int num_nodes, int w, int h, int d, bool periodic){
+    std::ostringstream key;
+    key << dimensions << "d-";
+    if(dimensions == 3) key << w << "x" << h << "x" << d;
+    else if(dimensions == 2) key << w << "x" << h;
+    else key << num_nodes;
+    if(periodic) key << "-p";
+    return key.str();
+}
+
+/*
+metodo: lookup
+descripcion: Busca en la base de datos la configuración guardada para la llave y huella dadas.
+             Si hay varias entradas se queda con la última (la más reciente)
+retorno: true si se encontró una configuración
+*/
+bool Autotuner::lookup(const std::string& path, const std::string& key,
+                       const std::string& fingerprint, TuningConfig& out){
+    std::ifstream f(path);
+    if(!f.is_open()) return false;
+
+    bool encontrado = false;
+    std::string linea;
+    while(std::getline(f, linea)){
+        if(linea.empty() || linea[0] == '#') continue;
+        std::istringstream in(linea);
+        std::string k, fp;
+        int sch, ch, th, var;
+        double t;
+        if(!(in >> k >> fp >> sch >> ch >> th >> var >> t)) continue;
+        if(k == key && fp == fingerprint){
+            out = TuningConfig(sch, ch, th, var, t);
+            encontrado = true;
+        }
+    }
+    return encontrado;
+}
+
+/*
+metodo: store
+descripcion: Agrega una configuración a la base de datos de tuning
+retorno: -
+*/
+void Autotuner::store(const std::string& path, const std::string& key,
+                      const std::string& fingerprint, const TuningConfig& cfg){
+    const bool nuevo = !std::filesystem::exists(path);
+    std::ofstream f(path, std::ios::app);
+    if(nuevo) f << "#key fingerprint schedule chunk threads variant time\n";
+    f << key << " " << fingerprint << " "
+      << cfg.getSchedule() << " " << cfg.getChunk() << " " << cfg.getThreads() << " "
+      << cfg.getVariant() << " " << cfg.getTime() << "\n";
+}
+
+/*
+metodo: tune
+descripcion: Búsqueda corta sobre schedule x chunk x threads x variante del kernel. Cada candidato se mide
+             con repeticiones adaptativas sobre una red del mismo tamaño y se elige la menor mediana
+retorno: la mejor configuración encontrada
+*/
+TuningConfig Autotuner::tune(int dimensions, int num_nodes, int w, int h, int d, bool periodic, int steps){
+    std::vector<int> schedules = {0, 1, 2, 3};   // 3 = robo de trabajo
+    std::vector<int> chunks    = {0, 16, 64, 256};
+    std::vector<int> variants  = {0};
+    if(dimensions >= 2) variants.push_back(1);
+
+    std::vector<int> threads;
+    for(int p = 1; p <= omp_get_num_procs(); p *= 2) threads.push_back(p);
+    if(threads.back() != omp_get_num_procs()) threads.push_back(omp_get_num_procs());
+
+    Network net(num_nodes, 0.1, 0.01);
+    net.initializeRegularNetwork(dimensions, w, h, d,
+                                 periodic ? Network::Boundary::Periodic : Network::Boundary::Open);
+    net.setTimeStep(0.01);
+    net.setSources(std::vector<double>(num_nodes, 0.0));
+    net.setAmplitude(num_nodes/2, 1.0);
+
+    auto medir = [&](int sch, int ch, int p, int var){
+        omp_set_num_threads(p);
+        double t0 = omp_get_wtime();
+        for(int s = 0; s < steps; ++s){
+            if(var == 1)    net.propagateWavesCollapse();
+            else if(ch > 0) net.propagateWaves(sch, ch);
+            else            net.propagateWaves(sch);
+        }
+        return omp_get_wtime() - t0;
+    };
+
+    TuningConfig mejor;
+    bool hay_mejor = false;
+    for(int var : variants){
+        for(int p : threads){
+            for(int sch : schedules){
+                for(int ch : chunks){
+                    //La variante collapse usa siempre schedule static sin chunk
+                    if(var == 1 && (sch != 0 || ch != 0)) continue;
+
+                    Estadisticas t = Benchmark::sampleAdaptive(
+                        [&](){ return medir(sch, ch, p, var); }, 3, 10, 0.10);
+
+                    if(!hay_mejor || t.getMediana() < mejor.getTime()){
+                        mejor = TuningConfig(sch, ch, p, var, t.getMediana());
+                        hay_mejor = true;
+                    }
+                }
+            }
+        }
+    }
+    return mejor;
+}
+
+/*
+metodo: runAutotune
+descripcion: Ejecuta la búsqueda para la topología dada y guarda el ganador en la base de datos
+retorno: entero que indica si funciona correctamente
+*/
+int Autotuner::runAutotune(int dimensions, int num_nodes, int w, int h, int d, bool periodic){
+    //Cada candidato se mide con sus hebras, sin la política de ejecución automática
+    ExecutionPolicy::setMode(ExecutionPolicy::Mode::Parallel);
+    std::filesystem::create_directories("datos");
+
+    const std::string key = makeKey(dimensions, num_nodes, w, h, d, periodic);
+    const std::string fp = machineFingerprint();
+
+    std::cout << "Autotune para " << key << " (maquina " << fp << ")...\n";
+    TuningConfig cfg = tune(dimensions, num_nodes, w, h, d, periodic, 50);
+    store(kTuningPath, key, fp, cfg);
+
+    std::cout << "Mejor configuracion: schedule=" << cfg.getSchedule()
+              << " chunk=" << cfg.getChunk()
+              << " threads=" << cfg.getThreads()
+              << " variante=" << cfg.getVariant()
+              << " (" << cfg.getTime() << "s por 50 pasos)\n";
+    return 0;
+}
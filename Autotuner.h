@@ -0,0 +1,55 @@
+#ifndef AUTOTUNER_H
+#define AUTOTUNER_H
+
+#include <string>
+
+/*
+Abstracción:
+Clases encargadas de buscar la mejor configuración de paralelización (schedule, chunk, threads y variante
+del kernel) para una topología y tamaño dados, y de guardarla en una base de datos local para reutilizarla
+*/
+
+class TuningConfig{
+public:
+    //constructores
+    TuningConfig() : schedule(0), chunk(0), threads(1), variant(0), time(0.0) {}
+    TuningConfig(int schedule, int chunk, int threads, int variant, double time)
+        : schedule(schedule), chunk(chunk), threads(threads), variant(variant), time(time) {}
+
+    //getters
+    int getSchedule() const { return schedule; }
+    int getChunk() const { return chunk; }
+    int getThreads() const { return threads; }
+    int getVariant() const { return variant; }  // 0 = propagateWaves, 1 = propagateWavesCollapse
+    double getTime() const { return time; }
+
+private:
+    //datos privados
+    int schedule;
+    int chunk;
+    int threads;
+    int variant;
+    double time;
+};
+
+class Autotuner{
+public:
+    //Archivo por defecto de la base de datos de tuning
+    static constexpr const char* kTuningPath = "datos/tuning.db";
+
+    //otros metodos
+    static std::string machineFingerprint();
+    static std::string makeKey(int dimensions, int num_nodes, int w = 0, int h = 0, int d = 1,
+                               bool periodic = false);
+
+    static bool lookup(const std::string& path, const std::string& key,
+                       const std::string& fingerprint, TuningConfig& out);
+    static void store(const std::string& path, const std::string& key,
+                      const std::string& fingerprint, const TuningConfig& cfg);
+
+    static TuningConfig tune(int dimensions, int num_nodes, int w, int h, int d, bool periodic, int steps);
+    static int runAutotune(int dimensions, int num_nodes, int w = 0, int h = 0, int d = 1,
+                           bool periodic = false);
+};
+
+#endif
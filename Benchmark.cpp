@@ -1,17 +1,40 @@
 #include <cmath>
 #include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
 #include <omp.h>
+#include <unistd.h>
 #include <filesystem> 
 
 #include "Benchmark.h"
 #include "Network.h"
+#include "ExecutionPolicy.h"
 
 /*
-metodo: computeMeanStd
-descripcion: Calcula la media y la desviación estandar de un conjunto de tiempos
-retorno: -
+metodo: percentil
+descripcion: Obtiene el percentil q (0..1) de un vector ordenado usando interpolación lineal
+retorno: double con el valor del percentil
 */
-static Estadisticas computeMeanStd(const std::vector<double>& v){
+static double percentil(const std::vector<double>& ordenado, double q){
+    if(ordenado.empty()) return 0.0;
+    const double pos = q * static_cast<double>(ordenado.size() - 1);
+    const size_t lo = static_cast<size_t>(std::floor(pos));
+    const size_t hi = std::min(lo + 1, ordenado.size() - 1);
+    const double frac = pos - static_cast<double>(lo);
+    return ordenado[lo] + frac * (ordenado[hi] - ordenado[lo]);
+}
+
+/*
+metodo: computeStats
+descripcion: Calcula la media y la desviación estandar de un conjunto de tiempos, junto con
+             estadisticos robustos: mediana, MAD, percentiles 5/95, intervalo de confianza
+             del 95% de la mediana (por estadisticos de orden, sin suponer normalidad) y la
+             cantidad de valores atipicos (|x - mediana| > 3 sigma robusta)
+retorno: Estadisticas con todos los valores calculados
+*/
+Estadisticas Benchmark::computeStats(const std::vector<double>& v){
     if(v.empty()) return Estadisticas(0.0, 0.0);
 
     //Definimos la variable para conseguir la media
@@ -31,8 +54,55 @@ static Estadisticas computeMeanStd(const std::vector<double>& v){
         s2 /= static_cast<double>(v.size() - 1);
     }
 
+    //Estadisticos robustos sobre la muestra ordenada
+    std::vector<double> ordenado(v);
+    std::sort(ordenado.begin(), ordenado.end());
+    const int n = static_cast<int>(ordenado.size());
+    const double mediana = percentil(ordenado, 0.5);
+
+    std::vector<double> desvios;
+    desvios.reserve(n);
+    for(double x : ordenado) desvios.push_back(std::fabs(x - mediana));
+    std::sort(desvios.begin(), desvios.end());
+    const double mad = percentil(desvios, 0.5);
+
+    //IC 95% de la mediana: rangos n/2 -+ 1.96*sqrt(n)/2 (en base 1)
+    const double z = 1.96;
+    const double ancho = z * std::sqrt(static_cast<double>(n)) / 2.0;
+    int lo = static_cast<int>(std::floor(n / 2.0 - ancho)) - 1;
+    int hi = static_cast<int>(std::ceil(1.0 + n / 2.0 + ancho)) - 1;
+    lo = std::max(0, lo);
+    hi = std::min(n - 1, hi);
+
+    int atipicos = 0;
+    const double limite = 3.0 * 1.4826 * mad;
+    for(double d : desvios) if(mad > 0.0 && d > limite) ++atipicos;
+
     //Devolvemos los valores
-    return Estadisticas(m, std::sqrt(s2));
+    Estadisticas e(m, std::sqrt(s2));
+    e.setRobustos(mediana, mad, percentil(ordenado, 0.05), percentil(ordenado, 0.95),
+                  ordenado[lo], ordenado[hi], n, atipicos);
+    return e;
+}
+
+/*
+metodo: sampleAdaptive
+descripcion: Repite la medición hasta que el intervalo de confianza de la mediana tenga un ancho
+             relativo menor a rel_ci_width, con al menos min_reps y como máximo max_reps repeticiones
+retorno: Estadisticas de las muestras obtenidas
+*/
+Estadisticas Benchmark::sampleAdaptive(const std::function<double()>& runFn,
+                                       int min_reps, int max_reps, double rel_ci_width){
+    std::vector<double> times;
+    times.reserve(max_reps);
+    for(int r = 0; r < min_reps; ++r) times.push_back(runFn());
+
+    Estadisticas t = computeStats(times);
+    while(static_cast<int>(times.size()) < max_reps && t.getAnchoRelativoIC() > rel_ci_width){
+        times.push_back(runFn());
+        t = computeStats(times);
+    }
+    return t;
 }
 
 /*
@@ -56,7 +126,7 @@ double Benchmark::run_once_benchmark(int schedule, int chunk, int threads){
     net.initializeRegularNetwork(2, 100, 100);
     net.setTimeStep(dt);
     net.setSources(sources);
-    net.getNode(num_nodes/2).setAmplitude(1.0);
+    net.setAmplitude(num_nodes/2, 1.0);
 
     double t0 = omp_get_wtime();
     for (int step = 0; step < num_steps; ++step){
@@ -68,40 +138,71 @@ double Benchmark::run_once_benchmark(int schedule, int chunk, int threads){
 }
 
 
+/*
+metodo: run_once_benchmark_irregular
+descripcion: Igual que run_once_benchmark pero sobre una red libre de escala (Barabási–Albert, m = 3), donde los
+             grados siguen una ley de potencia y el costo por nodo es muy desigual. La red se construye una sola vez
+retorno: tiempo de la corrida
+*/
+double Benchmark::run_once_benchmark_irregular(int schedule, int chunk, int threads){
+    omp_set_num_threads(threads);
+
+    constexpr int num_nodes = 100000;
+    constexpr double dt = 0.01;
+    constexpr int num_steps = 50;
+
+    static Network net = [](){
+        Network red(num_nodes, 0.1, 0.01);
+        red.initializeScaleFreeNetwork(3);
+        red.setTimeStep(dt);
+        red.setZeroSource();
+        return red;
+    }();
+    net.resetState();
+    net.setAmplitude(0, 1.0);
+
+    double t0 = omp_get_wtime();
+    for (int step = 0; step < num_steps; ++step){
+        if(chunk > 0)   net.propagateWaves(schedule, chunk);
+        else            net.propagateWaves(schedule);
+    }
+    double t1 = omp_get_wtime();
+    return (t1 - t0);
+}
+
 /*
 metodo: runGrid
 descripcion: Ejecuta una malla de combinaciones de parámetros y recopila los resultados 
-             (schedule x chunk x threads), para cada ejecución obtiene promedios de tiempo, errores.
+             (schedule x chunk x threads), cada combinación se repite de forma adaptativa
+             y el speedup se calcula con las medianas y la sigma robusta.
 retorno: -
 */
 std::vector<RunResults> Benchmark::runGrid(
     const std::vector<int>& schedules,
     const std::vector<int>& chunks,
     const std::vector<int>& threadsList,
-    int repetitions,
+    int min_reps, int max_reps, double rel_ci_width,
     const std::function<double(int,int,int)>& runFn,
-    double t1_mean, double t1_std){
+    const Estadisticas& t1){
 
     //Declaramos la salida, que sera un vector de tipo "RunResults"
     std::vector<RunResults> out;
     out.reserve(schedules.size() * chunks.size() * threadsList.size());
 
+    const double t1_med = t1.getMediana();
+
     //Vamos a hacer un for por cada "item" que tengamos
     for(int p : threadsList){
         for (int sch : schedules){
             for (int ch : chunks){
-                std::vector<double> times;
-                times.reserve(repetitions);
-                for(int r = 0; r < repetitions; ++r){
-                    times.push_back(runFn(sch, ch, p));
-                }
-                Estadisticas t = computeMeanStd(times);
-
-                const double Sp = (t1_mean > 0.0) ? (t1_mean / t.getMedia()) : 0.0;
+                Estadisticas t = sampleAdaptive([&](){ return runFn(sch, ch, p); },
+                                                min_reps, max_reps, rel_ci_width);
+
+                const double Sp = (t.getMediana() > 0.0) ? (t1_med / t.getMediana()) : 0.0;
                 const double Ep = (p > 0) ? (Sp / p) : 0.0;
 
-                const double rel_T1 = (t1_mean > 0.0) ? (t1_std /t1_mean) : 0.0;
-                const double rel_Tp = (t.getMedia() > 0.0) ? (t.getStddev() / t.getMedia()) : 0.0;
+                const double rel_T1 = (t1_med > 0.0) ? (t1.getSigmaRobusta() / t1_med) : 0.0;
+                const double rel_Tp = (t.getMediana() > 0.0) ? (t.getSigmaRobusta() / t.getMediana()) : 0.0;
                 const double sigma_Sp = Sp * std::sqrt(rel_T1*rel_T1 + rel_Tp*rel_Tp);
                 const double sigma_Ep = (p > 0) ? (sigma_Sp / p) : 0.0;
 
@@ -120,37 +221,144 @@ std::vector<RunResults> Benchmark::runGrid(
 
 /*
 metodo: writeDat
-descripcion: Los resultados obtenidos de la grilla se escriben en un archivo .dat
+descripcion: Los resultados obtenidos de la grilla se escriben en un archivo .dat, las columnas
+             robustas van al final para mantener compatibilidad con analisis.py
 retorno: -
 */
 void Benchmark::writeDat(const std::string& path, const std::vector<RunResults>& rows) {
     std::ofstream f(path);
-    f << "#threads schedule chunk time_mean time_std speedup efficiency sigma_Sp sigma_Ep\n";
+    f << "#threads schedule chunk time_mean time_std speedup efficiency sigma_Sp sigma_Ep"
+      << " time_median time_mad time_p05 time_p95 ci_low ci_high samples outliers\n";
     for (const auto& r : rows) {
+        const Estadisticas& t = r.getTime();
         f << r.getThreads() << " "
           << r.getSchedule() << " "
           << r.getChunk() << " "
-          << r.getTime().getMedia() << " "
-          << r.getTime().getStddev() << " "
+          << t.getMedia() << " "
+          << t.getStddev() << " "
           << r.getSpeedup() << " "
           << r.getEfficiency() << " "
           << r.getSpeedupErr().getMedia() << " "
-          << r.getEfficiencyErr() << "\n";
+          << r.getEfficiencyErr() << " "
+          << t.getMediana() << " "
+          << t.getMad() << " "
+          << t.getP05() << " "
+          << t.getP95() << " "
+          << t.getIcInf() << " "
+          << t.getIcSup() << " "
+          << t.getMuestras() << " "
+          << t.getAtipicos() << "\n";
     }
 }
 
+/*
+metodo: loadDat
+descripcion: Lee un archivo de resultados escrito por writeDat. Si el archivo es del formato antiguo
+             (sin columnas robustas) se usa la media como mediana y media -+ 2 stddev como intervalo
+retorno: vector con las filas leidas (vacio si no se pudo abrir)
+*/
+std::vector<RunResults> Benchmark::loadDat(const std::string& path){
+    std::vector<RunResults> rows;
+    std::ifstream f(path);
+    if(!f.is_open()){
+        std::cerr << "No se pudo abrir el archivo de resultados: " << path << "\n";
+        return rows;
+    }
+
+    std::string linea;
+    while(std::getline(f, linea)){
+        if(linea.empty() || linea[0] == '#') continue;
+        std::istringstream in(linea);
+        std::vector<double> c;
+        double x;
+        while(in >> x) c.push_back(x);
+        if(c.size() < 9) continue;
+
+        Estadisticas t(c[3], c[4]);
+        if(c.size() >= 17){
+            t.setRobustos(c[9], c[10], c[11], c[12], c[13], c[14],
+                          static_cast<int>(c[15]), static_cast<int>(c[16]));
+        } else {
+            t.setRobustos(c[3], c[4] / 1.4826, c[3], c[3],
+                          c[3] - 2.0 * c[4], c[3] + 2.0 * c[4], 0, 0);
+        }
+        rows.emplace_back(static_cast<int>(c[0]), static_cast<int>(c[1]), static_cast<int>(c[2]),
+                          t, c[5], c[6], Estadisticas(c[7], 0.0), c[8]);
+    }
+    return rows;
+}
+
+/*
+metodo: compareResults
+descripcion: Compara los resultados actuales contra una linea base por configuración (threads, schedule, chunk).
+             Una configuración es una regresión si los IC de la mediana no se solapan y la mediana empeora
+             más que kUmbralRegresion; es una mejora en el caso simétrico. Escribe el reporte en path
+retorno: cantidad de regresiones encontradas
+*/
+int Benchmark::compareResults(const std::vector<RunResults>& baseline,
+                              const std::vector<RunResults>& current,
+                              const std::string& path){
+    std::ofstream f(path);
+    f << "#threads schedule chunk base_median base_ci_low base_ci_high"
+      << " new_median new_ci_low new_ci_high rel_change status\n";
+
+    int regresiones = 0;
+    int mejoras = 0;
+    for(const auto& r : current){
+        const RunResults* base = nullptr;
+        for(const auto& b : baseline){
+            if(b.getThreads() == r.getThreads() && b.getSchedule() == r.getSchedule()
+               && b.getChunk() == r.getChunk()){
+                base = &b;
+                break;
+            }
+        }
+        if(!base) continue;
+
+        const Estadisticas& tb = base->getTime();
+        const Estadisticas& tn = r.getTime();
+        const double rel = (tb.getMediana() > 0.0)
+            ? (tn.getMediana() - tb.getMediana()) / tb.getMediana() : 0.0;
+
+        std::string estado = "SIN_CAMBIO";
+        if(tn.getIcInf() > tb.getIcSup() && rel > kUmbralRegresion){
+            estado = "REGRESION";
+            ++regresiones;
+        } else if(tn.getIcSup() < tb.getIcInf() && -rel > kUmbralRegresion){
+            estado = "MEJORA";
+            ++mejoras;
+        }
+
+        f << r.getThreads() << " " << r.getSchedule() << " " << r.getChunk() << " "
+          << tb.getMediana() << " " << tb.getIcInf() << " " << tb.getIcSup() << " "
+          << tn.getMediana() << " " << tn.getIcInf() << " " << tn.getIcSup() << " "
+          << rel << " " << estado << "\n";
+
+        if(estado == "REGRESION"){
+            std::cout << "[REGRESION] threads=" << r.getThreads() << " schedule=" << r.getSchedule()
+                      << " chunk=" << r.getChunk() << " mediana " << tb.getMediana()
+                      << "s -> " << tn.getMediana() << "s (" << rel * 100.0 << "%)\n";
+        }
+    }
+
+    std::cout << "Comparacion con linea base: " << regresiones << " regresiones, "
+              << mejoras << " mejoras. Reporte en '" << path << "'\n";
+    return regresiones;
+}
+
 /*
 metodo: writeScalingAnalysis
-descripcion: Para cada número de threads, selecciona la mejor configuración (menor tiempo)
+descripcion: Para cada número de threads, selecciona la mejor configuración (menor mediana)
              y escribe un análisis de escalabilidad en un archivo .dat
 retorno: -
 */
 void Benchmark::writeScalingAnalysis(const std::vector<RunResults>& rows,
-                                 double t1_mean, double t1_std,
+                                 const Estadisticas& t1,
                                  const std::string& path) {
-    // Agrupa por threads y selecciona la fila con menor time_mean
+    // Agrupa por threads y selecciona la fila con menor mediana
     std::ofstream f(path);
-    f << "#threads time_mean time_std speedup efficiency sigma_Sp sigma_Ep schedule chunk\n";
+    f << "#threads time_mean time_std speedup efficiency sigma_Sp sigma_Ep schedule chunk"
+      << " time_median ci_low ci_high\n";
 
     // Recolectar conjunto de threads
     std::vector<int> all_threads;
@@ -159,69 +367,347 @@ void Benchmark::writeScalingAnalysis(const std::vector<RunResults>& rows,
     std::sort(all_threads.begin(), all_threads.end());
     all_threads.erase(std::unique(all_threads.begin(), all_threads.end()), all_threads.end());
 
+    const double t1_med = t1.getMediana();
+
     for (int p : all_threads) {
         const RunResults* best = nullptr;
         for (const auto& r : rows) {
             if (r.getThreads() != p) continue;
-            if (!best || r.getTime().getMedia() < best->getTime().getMedia()) best = &r;
+            if (!best || r.getTime().getMediana() < best->getTime().getMediana()) best = &r;
         }
         if (!best) continue;
 
-        const double Tp_mean = best->getTime().getMedia();
-        const double Tp_std  = best->getTime().getStddev();
+        const Estadisticas& tp = best->getTime();
+        const double Tp_med = tp.getMediana();
 
-        const double Sp = (Tp_mean > 0.0) ? (t1_mean / Tp_mean) : 0.0;
+        const double Sp = (Tp_med > 0.0) ? (t1_med / Tp_med) : 0.0;
         const double Ep = (p > 0) ? (Sp / p) : 0.0;
 
-        const double rel_T1 = (t1_mean > 0.0) ? (t1_std / t1_mean) : 0.0;
-        const double rel_Tp = (Tp_mean > 0.0) ? (Tp_std / Tp_mean) : 0.0;
+        const double rel_T1 = (t1_med > 0.0) ? (t1.getSigmaRobusta() / t1_med) : 0.0;
+        const double rel_Tp = (Tp_med > 0.0) ? (tp.getSigmaRobusta() / Tp_med) : 0.0;
         const double sigma_Sp = Sp * std::sqrt(rel_T1*rel_T1 + rel_Tp*rel_Tp);
         const double sigma_Ep = (p > 0) ? (sigma_Sp / p) : 0.0;
 
         f << p << " "
-          << Tp_mean << " " << Tp_std << " "
+          << tp.getMedia() << " " << tp.getStddev() << " "
           << Sp << " " << Ep << " "
           << sigma_Sp << " " << sigma_Ep << " "
-          << best->getSchedule() << " " << best->getChunk() << "\n";
+          << best->getSchedule() << " " << best->getChunk() << " "
+          << Tp_med << " " << tp.getIcInf() << " " << tp.getIcSup() << "\n";
     }
 }
 
+/*
+metodo: writeMemoryReport
+descripcion: Escribe la memoria de las redes usadas en el benchmark (malla 2D e irregular): bytes por componente,
+             bytes por nodo y por arista, y la memoria residente máxima del proceso
+retorno: -
+*/
+void Benchmark::writeMemoryReport(const std::string& path){
+    std::ofstream f(path);
+    if(!f.is_open()){
+        std::cerr << "No se pudo abrir " << path << std::endl;
+        return;
+    }
+    f << "#red nodos aristas topologia asignador estado fuentes scratch otros total bytes_por_nodo bytes_por_arista rss_pico\n";
+
+    auto fila = [&](const std::string& nombre, const Network& net){
+        const Network::MemoryFootprint m = net.getMemoryFootprint();
+        f << nombre << " " << m.nodes << " " << m.edges << " "
+          << m.topology << " " << m.allocator << " " << m.state << " " << m.sources << " "
+          << m.scratch << " " << m.other << " " << m.total() << " "
+          << std::fixed << std::setprecision(2) << m.bytesPerNode() << " " << m.bytesPerEdge() << " "
+          << Network::peakRssBytes() << "\n";
+        //Se formatea aparte para no dejar std::cout en notación fija para el resto de la corrida
+        std::ostringstream linea;
+        linea << "Memoria " << nombre << ": " << m.total() << " bytes ("
+              << std::fixed << std::setprecision(1) << m.bytesPerNode() << " B/nodo, "
+              << m.bytesPerEdge() << " B/arista)";
+        std::cout << linea.str() << std::endl;
+    };
+
+    Network malla(10000, 0.1, 0.01);
+    malla.initializeRegularNetwork(2, 100, 100);
+    fila("malla_2d", malla);
+
+    Network irregular(100000, 0.1, 0.01);
+    irregular.initializeScaleFreeNetwork(3);
+    fila("libre_escala", irregular);
+}
+
+/*
+metodo: writeLayoutComparison
+descripcion: Compara el kernel de listas de vecinos con el de SELL-C-sigma sobre redes aleatoria, de mundo pequeño
+             y libre de escala de 100.000 nodos, con 1 hebra y con el máximo disponible (schedule static)
+retorno: -
+*/
+void Benchmark::writeLayoutComparison(const std::string& path){
+    std::ofstream f(path);
+    if(!f.is_open()){
+        std::cerr << "No se pudo abrir " << path << std::endl;
+        return;
+    }
+    f << "#red hebras listas_mediana listas_ic_inf listas_ic_sup sell_mediana sell_ic_inf sell_ic_sup speedup eficiencia_relleno\n";
+
+    constexpr int num_nodes = 100000;
+    constexpr int num_steps = 50;
+    const int maximo = omp_get_max_threads();
+    std::vector<int> hebras = {1};
+    if(maximo > 1) hebras.push_back(maximo);
+
+    auto comparar = [&](const std::string& nombre, Network& net){
+        net.setTimeStep(0.01);
+        net.setZeroSource();
+        auto medir = [&](bool sell, int p){
+            net.setSellLayout(sell);
+            net.propagateWaves(0);    // la representación se construye fuera de la medición
+            return Benchmark::sampleAdaptive([&](){
+                omp_set_num_threads(p);
+                net.resetState();
+                net.setAmplitude(0, 1.0);
+                const double t0 = omp_get_wtime();
+                for(int step = 0; step < num_steps; ++step) net.propagateWaves(0);
+                return omp_get_wtime() - t0;
+            }, kMinRepeticiones, kMaxRepeticiones, kAnchoRelativoIC);
+        };
+        for(int p : hebras){
+            const Estadisticas listas = medir(false, p);
+            const Estadisticas sell = medir(true, p);
+            const double speedup = listas.getMediana() / sell.getMediana();
+            f << nombre << " " << p << " " << listas.getMediana() << " " << listas.getIcInf() << " " << listas.getIcSup()
+              << " " << sell.getMediana() << " " << sell.getIcInf() << " " << sell.getIcSup() << " " << speedup
+              << " " << net.getSellLayout().fillEfficiency() << "\n";
+            std::cout << "SELL-C-sigma " << nombre << " (" << p << " hebras): speedup " << speedup << std::endl;
+        }
+        net.setSellLayout(false);
+    };
+
+    Network aleatoria(num_nodes, 0.1, 0.01);
+    aleatoria.initializeRandomNetwork(6.0 / (num_nodes - 1));
+    comparar("aleatoria", aleatoria);
+
+    Network mundo(num_nodes, 0.1, 0.01);
+    mundo.initializeSmallWorldNetwork(6, 0.1);
+    comparar("mundo_pequeno", mundo);
+
+    Network libre(num_nodes, 0.1, 0.01);
+    libre.initializeScaleFreeNetwork(3);
+    comparar("libre_escala", libre);
+
+    omp_set_num_threads(maximo);
+}
+
+/*
+metodo: cacheSizes
+descripcion: Tamaños de las caché L1 de datos, L2 y L3 según sysconf (0 si el sistema no los informa)
+retorno: -
+*/
+void Benchmark::cacheSizes(size_t& l1, size_t& l2, size_t& l3){
+    auto leer = [](int nombre) -> size_t {
+        const long v = sysconf(nombre);
+        return v > 0 ? static_cast<size_t>(v) : 0;
+    };
+    l1 = leer(_SC_LEVEL1_DCACHE_SIZE);
+    l2 = leer(_SC_LEVEL2_CACHE_SIZE);
+    l3 = leer(_SC_LEVEL3_CACHE_SIZE);
+}
+
+/*
+metodo: streamTriad
+descripcion: Ancho de banda estilo STREAM triad, a[i] = b[i] + s c[i], con arreglos de n doubles inicializados
+             en paralelo (primer toque). Se cuentan 24 bytes por elemento, como STREAM (sin el write-allocate), y
+             se informa la mejor de varias repeticiones
+retorno: GB/s
+*/
+double Benchmark::streamTriad(size_t n){
+    std::vector<double> a(n), b(n), c(n);
+    const long long N = static_cast<long long>(n);
+    #pragma omp parallel for schedule(static)
+    for(long long i = 0; i < N; ++i){ a[i] = 0.0; b[i] = 1.0; c[i] = 2.0; }
+
+    const double s = 3.0;
+    const int vueltas = std::max<long long>(1, static_cast<long long>(2e8 / (24.0 * N)));
+    double mejor = 1e300;
+    for(int rep = 0; rep < 7; ++rep){
+        const double t0 = omp_get_wtime();
+        for(int v = 0; v < vueltas; ++v){
+            #pragma omp parallel for schedule(static)
+            for(long long i = 0; i < N; ++i) a[i] = b[i] + s * c[i];
+        }
+        mejor = std::min(mejor, (omp_get_wtime() - t0) / vueltas);
+    }
+    if(a[N / 2] != 7.0) std::cerr << "[streamTriad] resultado inesperado" << std::endl;
+    return 24.0 * N / mejor / 1e9;
+}
+
+/*
+metodo: kernelBytesPerNode
+descripcion: Tráfico mínimo del kernel de malla con fuente densa por nodo y paso: leer A y S y escribir A'
+             (los vecinos se reutilizan desde caché). Misma convención que STREAM, sin write-allocate
+retorno: bytes por nodo
+*/
+double Benchmark::kernelBytesPerNode(){
+    return 3.0 * sizeof(double);
+}
+
+/*
+metodo: kernelFlopsPerNode
+descripcion: Operaciones de punto flotante por nodo: una resta y una suma por vecino, más D*suma, gamma*A,
+             la fuente, dt*(...) y A + delta
+retorno: flops por nodo
+*/
+double Benchmark::kernelFlopsPerNode(int degree){
+    return 2.0 * degree + 6.0;
+}
+
+/*
+metodo: runMemorySweep
+descripcion: (1) barrido de tamaños de malla 2D que cruza L1/L2/L3/DRAM: en cada punto se mide el tiempo por paso
+             y se compara el ancho de banda logrado con un STREAM triad del mismo tamaño de trabajo (roofline con
+             la intensidad aritmética del kernel). (2) escalamiento débil: N crece con la cantidad de hebras
+retorno: 0 si termina correctamente
+*/
+int Benchmark::runMemorySweep(){
+    //Se mide con las hebras pedidas, sin que la política de ejecución cambie a serie en los tamaños chicos
+    ExecutionPolicy::setMode(ExecutionPolicy::Mode::Parallel);
+    std::filesystem::create_directories("datos");
+    size_t l1, l2, l3;
+    cacheSizes(l1, l2, l3);
+    const double bytes_nodo = kernelBytesPerNode();
+    const double intensidad = kernelFlopsPerNode(4) / bytes_nodo;
+    const int hebras = omp_get_max_threads();
+
+    const double bw_dram = streamTriad(std::max<size_t>(l3 * 4 / sizeof(double), size_t(1) << 24));
+    std::cout << "STREAM triad (DRAM): " << bw_dram << " GB/s, intensidad del kernel: "
+              << intensidad << " flop/byte" << std::endl;
+
+    auto nivel = [&](double bytes) -> const char* {
+        if(l1 && bytes <= l1) return "L1";
+        if(l2 && bytes <= l2) return "L2";
+        if(l3 && bytes <= l3) return "L3";
+        return "DRAM";
+    };
+
+    //Mide el tiempo por paso (mediana) de una malla W x H con fuente densa
+    auto medirPaso = [](int W, int H, int pasos){
+        Network net(W * H, 0.1, 0.01);
+        net.initializeRegularNetwork(2, W, H);
+        net.setTimeStep(0.01);
+        net.setSources(std::vector<double>(W * H, 0.001));
+        net.setAmplitude(W * H / 2, 1.0);
+        net.propagateWaves(0);
+        Estadisticas t = sampleAdaptive([&](){
+            const double t0 = omp_get_wtime();
+            for(int k = 0; k < pasos; ++k) net.propagateWaves(0);
+            return (omp_get_wtime() - t0) / pasos;
+        }, kMinRepeticiones, 10, kAnchoRelativoIC);
+        return t.getMediana();
+    };
+
+    //(1) Barrido de tamaños
+    std::ofstream f("datos/roofline.dat");
+    f << "#L1 " << l1 << " L2 " << l2 << " L3 " << l3 << " hebras " << hebras
+      << " stream_dram_GBs " << bw_dram << " intensidad " << intensidad << "\n";
+    f << "#nodos bytes_trabajo nivel tiempo_paso GBs GFLOPs stream_GBs fraccion_stream cota_roofline_GFLOPs\n";
+
+    const double max_bytes = std::min(std::max(4.0 * l3, 64.0 * (1 << 20)), kMaxBytesBarrido);
+    for(double bytes = 16.0 * 1024; bytes <= max_bytes; bytes *= 2.0){
+        const int lado = std::max(8, static_cast<int>(std::sqrt(bytes / bytes_nodo)));
+        const long long N = static_cast<long long>(lado) * lado;
+        const double trabajo = N * bytes_nodo;
+        const int pasos = std::max(3, static_cast<int>(kActualizacionesPorPunto / N));
+
+        const double t = medirPaso(lado, lado, pasos);
+        const double gbs = N * bytes_nodo / t / 1e9;
+        const double gflops = N * kernelFlopsPerNode(4) / t / 1e9;
+        const double bw_local = streamTriad(static_cast<size_t>(N));
+        f << N << " " << static_cast<long long>(trabajo) << " " << nivel(trabajo) << " "
+          << std::scientific << std::setprecision(4) << t << " "
+          << std::fixed << std::setprecision(3) << gbs << " " << gflops << " " << bw_local << " "
+          << gbs / bw_local << " " << intensidad * bw_local << "\n";
+        std::cout << "N=" << N << " (" << nivel(trabajo) << "): " << gbs << " GB/s, "
+                  << 100.0 * gbs / bw_local << "% del STREAM" << std::endl;
+    }
+
+    //(2) Escalamiento débil: malla 512 x (512 p), el trabajo por hebra es constante
+    std::ofstream w("datos/weak scaling.dat");
+    w << "#hebras nodos tiempo_paso eficiencia_debil GBs\n";
+    std::vector<int> lista;
+    for(int p = 1; p <= hebras; p *= 2) lista.push_back(p);
+    if(lista.back() != hebras) lista.push_back(hebras);
+
+    double t1 = 0.0;
+    for(int p : lista){
+        omp_set_num_threads(p);
+        const int W = kNodosPorHebraLado, H = kNodosPorHebraLado * p;
+        const long long N = static_cast<long long>(W) * H;
+        const int pasos = std::max(3, static_cast<int>(kActualizacionesPorPunto / N));
+        const double t = medirPaso(W, H, pasos);
+        if(p == 1) t1 = t;
+        w << p << " " << N << " " << std::scientific << std::setprecision(4) << t << " "
+          << std::fixed << std::setprecision(3) << t1 / t << " " << N * bytes_nodo / t / 1e9 << "\n";
+        std::cout << "Debil p=" << p << ": eficiencia " << t1 / t << std::endl;
+    }
+    omp_set_num_threads(hebras);
+    return 0;
+}
+
 /*
 metodo: runBenchmark
 descripcion: Ejecuta una corrida de benchmark completa de manera automatica, mide T1, corre la grilla 
-             y escribe en los archivos .dat
-retorno: entero que indica si funciona correctamente
+             y escribe en los archivos .dat. Si se entrega baseline_path, compara contra esa linea base
+retorno: entero que indica si funciona correctamente (1 si se detectaron regresiones)
 */
-int Benchmark::runBenchmark(){
-    std::vector<int> schedules = {0, 1, 2};      // static, dynamic, guided
+int Benchmark::runBenchmark(const std::string& baseline_path){
+    //Se comparan schedules e hebras tal cual, sin la política de ejecución automática
+    ExecutionPolicy::setMode(ExecutionPolicy::Mode::Parallel);
+    std::vector<int> schedules = {0, 1, 2, 3};   // static, dynamic, guided, robo de trabajo
     std::vector<int> chunks    = {0, 64, 256};   // 0 => sin chunk explícito
     std::vector<int> threads   = {1, 2, 4, 8};
 
     std::filesystem::create_directories("datos");
 
-    std::vector<double> t1_samples;
-    for(int r = 0; r < 10; ++r){
-        t1_samples.push_back(Benchmark::run_once_benchmark(0, 0, 1));
+    //Se lee la linea base antes de sobreescribir los resultados
+    std::vector<RunResults> baseline;
+    if(!baseline_path.empty()){
+        baseline = Benchmark::loadDat(baseline_path);
+        if(baseline.empty()) return 1;
     }
 
-    double m = 0.0;
-    for(double x : t1_samples) m += x;
-    m /= t1_samples.size();
-    double s2 = 0.0;
-    for (double x : t1_samples){
-        double d = x - m;
-        s2 += d*d;
-    }
-    double s = (t1_samples.size() > 1) ? std::sqrt(s2/(t1_samples.size()-1)) : 0.0;
+    Estadisticas t1 = Benchmark::sampleAdaptive(
+        [](){ return Benchmark::run_once_benchmark(0, 0, 1); },
+        kMinRepeticiones, kMaxRepeticiones, kAnchoRelativoIC);
 
     auto results = Benchmark::runGrid(
         schedules, chunks, threads,
-        10,
+        kMinRepeticiones, kMaxRepeticiones, kAnchoRelativoIC,
         Benchmark::run_once_benchmark,
-        m, s);
+        t1);
 
     Benchmark::writeDat("datos/benchmark results.dat", results);
-    Benchmark::writeScalingAnalysis(results, m, s, "datos/scaling analysis.dat");
+    Benchmark::writeScalingAnalysis(results, t1, "datos/scaling analysis.dat");
+
+    //La misma grilla sobre una red libre de escala, donde el balance de carga importa
+    Estadisticas t1_irregular = Benchmark::sampleAdaptive(
+        [](){ return Benchmark::run_once_benchmark_irregular(0, 0, 1); },
+        kMinRepeticiones, kMaxRepeticiones, kAnchoRelativoIC);
+
+    auto irregular = Benchmark::runGrid(
+        schedules, chunks, threads,
+        kMinRepeticiones, kMaxRepeticiones, kAnchoRelativoIC,
+        Benchmark::run_once_benchmark_irregular,
+        t1_irregular);
+
+    Benchmark::writeDat("datos/benchmark irregular.dat", irregular);
+    Benchmark::writeScalingAnalysis(irregular, t1_irregular, "datos/scaling irregular.dat");
+
+    Benchmark::writeMemoryReport("datos/memory footprint.dat");
+    Benchmark::writeLayoutComparison("datos/benchmark sell.dat");
+
+    if(!baseline.empty()){
+        int regresiones = Benchmark::compareResults(baseline, results, "datos/regression report.dat");
+        return (regresiones > 0) ? 1 : 0;
+    }
 
     return 0;
-}
\ No newline at end of file
+}
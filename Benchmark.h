@@ -20,11 +20,42 @@ public:
     void setMedia(double v) { media = v; }
     void setStddev(double v) { stddev = v; }
 
+    //Estadisticos robustos (mediana, MAD, percentiles e intervalo de confianza de la mediana)
+    double getMediana() const { return mediana; }
+    double getMad() const { return mad; }
+    double getP05() const { return p05; }
+    double getP95() const { return p95; }
+    double getIcInf() const { return ic_inf; }
+    double getIcSup() const { return ic_sup; }
+    int getMuestras() const { return muestras; }
+    int getAtipicos() const { return atipicos; }
+    void setRobustos(double med, double mad_v, double p5, double p95_v,
+                     double ic_i, double ic_s, int n, int n_atipicos) {
+        mediana = med; mad = mad_v; p05 = p5; p95 = p95_v;
+        ic_inf = ic_i; ic_sup = ic_s; muestras = n; atipicos = n_atipicos;
+    }
+
+    //Sigma robusta (1.4826 * MAD), equivalente a stddev si la distribucion es normal
+    double getSigmaRobusta() const { return 1.4826 * mad; }
+
+    //Ancho relativo del intervalo de confianza de la mediana
+    double getAnchoRelativoIC() const {
+        return (mediana > 0.0) ? (ic_sup - ic_inf) / mediana : 0.0;
+    }
+
     
 private:
     //datos privados
     double media;
     double stddev;
+    double mediana = 0.0;
+    double mad = 0.0;
+    double p05 = 0.0;
+    double p95 = 0.0;
+    double ic_inf = 0.0;
+    double ic_sup = 0.0;
+    int muestras = 0;
+    int atipicos = 0;
 };
 
 class RunResults{
@@ -68,22 +99,55 @@ private:
 
 class Benchmark{
 public:
+    //Parametros de la repeticion adaptativa: se repite hasta que el IC 95% de la mediana
+    //tenga un ancho relativo menor a kAnchoRelativoIC, con un minimo y un maximo de repeticiones
+    static constexpr int kMinRepeticiones = 5;
+    static constexpr int kMaxRepeticiones = 50;
+    static constexpr double kAnchoRelativoIC = 0.05;
+
+    //Cambio relativo minimo de la mediana para considerar una regresion (ademas de no solaparse los IC)
+    static constexpr double kUmbralRegresion = 0.02;
+
     //Otros metodos
+    static Estadisticas computeStats(const std::vector<double>& samples);
+
+    static Estadisticas sampleAdaptive(const std::function<double()>& runFn,
+                                       int min_reps, int max_reps, double rel_ci_width);
+
     static std::vector<RunResults> runGrid(
         const std::vector<int>& schedules,
         const std::vector<int>& chunks,
         const std::vector<int>& threadsList,
-        int repetitions,
+        int min_reps, int max_reps, double rel_ci_width,
         const std::function<double(int, int, int)>& runFn,
-        double t1_promedio, double t1_std);
+        const Estadisticas& t1);
     
     static void writeDat(const std::string& path, const std::vector<RunResults>& rows);
+    static std::vector<RunResults> loadDat(const std::string& path);
+
+    static int compareResults(const std::vector<RunResults>& baseline,
+                              const std::vector<RunResults>& current,
+                              const std::string& path);
 
     static double run_once_benchmark(int schedule, int chunk, int threads);
+    static double run_once_benchmark_irregular(int schedule, int chunk, int threads);
 
     static void writeScalingAnalysis(const std::vector<RunResults>& rows,
-                                    double t1_mean, double t1_std,
+                                    const Estadisticas& t1,
                                     const std::string& path);
 
-    static int runBenchmark();
-};
\ No newline at end of file
+    static void writeMemoryReport(const std::string& path);
+    static void writeLayoutComparison(const std::string& path);
+
+    //Jerarquía de memoria: barrido de tamaños, escalamiento débil y roofline contra un STREAM triad medido
+    static constexpr double kActualizacionesPorPunto = 1e7;   // nodos x pasos por medición del barrido
+    static constexpr double kMaxBytesBarrido = 1024.0 * (1 << 20);  // tope del barrido (1 GiB de trabajo)
+    static constexpr int kNodosPorHebraLado = 512;              // escalamiento débil: malla 512 x (512 p)
+    static void cacheSizes(size_t& l1, size_t& l2, size_t& l3);
+    static double streamTriad(size_t n);
+    static double kernelBytesPerNode();
+    static double kernelFlopsPerNode(int degree);
+    static int runMemorySweep();
+
+    static int runBenchmark(const std::string& baseline_path = "");
+};
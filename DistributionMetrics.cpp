@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <omp.h>
+
+#include "DistributionMetrics.h"
+
+/*
+metodo: QuantileSketch
+descripcion: Constructor, reserva los buckets de cada signo para cubrir [kMinValor, kMaxValor] con error
+             relativo alpha
+retorno: -
+*/
+QuantileSketch::QuantileSketch(double alpha_) : alpha(alpha_) {
+    log_g = std::log((1.0 + alpha) / (1.0 - alpha));
+    desplazamiento = static_cast<int>(std::ceil(std::log(kMinValor) / log_g));
+    const int tope = static_cast<int>(std::ceil(std::log(kMaxValor) / log_g));
+    buckets = tope - desplazamiento + 1;
+    positivos.assign(buckets, 0);
+    negativos.assign(buckets, 0);
+}
+
+/*
+metodo: merge
+descripcion: Combina otro sketch con el mismo alpha sumando los conteos de cada bucket
+retorno: -
+*/
+void QuantileSketch::merge(const QuantileSketch& otro){
+    for(int k = 0; k < buckets; ++k){
+        positivos[k] += otro.positivos[k];
+        negativos[k] += otro.negativos[k];
+    }
+    ceros += otro.ceros;
+    total += otro.total;
+    no_finitos += otro.no_finitos;
+}
+
+/*
+metodo: clear
+descripcion: Deja el sketch vacío conservando los buckets
+retorno: -
+*/
+void QuantileSketch::clear(){
+    std::fill(positivos.begin(), positivos.end(), 0);
+    std::fill(negativos.begin(), negativos.end(), 0);
+    ceros = total = no_finitos = 0;
+}
+
+/*
+metodo: valor
+descripcion: Valor representativo del bucket k, que cubre (g^(i-1), g^i]: 2 g^i / (g + 1), a error relativo alpha
+retorno: double con el valor
+*/
+double QuantileSketch::valor(int k) const {
+    const double g = std::exp(log_g);
+    return 2.0 * std::exp((k + desplazamiento) * log_g) / (g + 1.0);
+}
+
+/*
+metodo: quantile
+descripcion: Cuantil q en [0, 1]: recorre los buckets de menor a mayor valor (negativos de mayor a menor
+             magnitud, ceros y positivos) hasta pasar el rango q (total - 1)
+retorno: double con el cuantil aproximado (0 si el sketch está vacío)
+*/
+double QuantileSketch::quantile(double q) const {
+    if(total == 0) return 0.0;
+    const double rango = std::clamp(q, 0.0, 1.0) * static_cast<double>(total - 1);
+    uint64_t acumulado = 0;
+    for(int k = buckets - 1; k >= 0; --k){
+        acumulado += negativos[k];
+        if(static_cast<double>(acumulado) > rango) return -valor(k);
+    }
+    acumulado += ceros;
+    if(static_cast<double>(acumulado) > rango) return 0.0;
+    for(int k = 0; k < buckets; ++k){
+        acumulado += positivos[k];
+        if(static_cast<double>(acumulado) > rango) return valor(k);
+    }
+    return valor(buckets - 1);
+}
+
+/*
+metodo: DistributionMetrics
+descripcion: Constructor
+retorno: -
+*/
+DistributionMetrics::DistributionMetrics(int bins_, double lo_, double hi_, const std::vector<double>& quantiles,
+                                         double alpha_)
+    :   bins(std::max(1, bins_)), lo(lo_), hi(hi_), cuantiles(quantiles), alpha(alpha_) {}
+
+/*
+metodo: compute
+descripcion: Resume el estado en una sola pasada paralela por bloques de kBloque elementos. En cada bloque un loop
+             SIMD calcula mínimo, máximo y suma, otro la suma de cuadrados centrada en la media del bloque (el bloque
+             sigue en L1) y un loop escalar llena el histograma y el sketch de la hebra (los NaN e infinitos solo se
+             cuentan). Media y varianza se combinan
+             con la fórmula de Chan; las parciales de cada hebra se combinan en orden de hebra, así el resultado no
+             depende de la planificación
+retorno: el resumen del estado
+*/
+DistributionMetrics::Resumen DistributionMetrics::compute(StateView A, double tiempo){
+    Resumen r;
+    r.paso = A.step();
+    r.tiempo = tiempo;
+    r.histograma.assign(bins + 2, 0);
+    const size_t n = A.size();
+    if(n == 0) return r;
+    const double* a = A.data();
+
+    //Rango automático: simétrico con la mayor magnitud del primer estado, y queda fijo para toda la serie
+    if(lo == hi){
+        double m = 0.0;
+        #pragma omp parallel for simd reduction(max:m) schedule(static)
+        for(size_t i = 0; i < n; ++i) m = std::max(m, std::isfinite(a[i]) ? std::fabs(a[i]) : 0.0);
+        if(m == 0.0) m = 1.0;
+        lo = -m;
+        hi = m;
+    }
+    const double escala = bins / (hi - lo);
+
+    struct Parcial{
+        double mn = std::numeric_limits<double>::infinity();
+        double mx = -std::numeric_limits<double>::infinity();
+        double cuenta = 0.0, media = 0.0, m2 = 0.0;
+        std::vector<uint64_t> hist;
+        uint64_t no_finitos = 0;
+    };
+    const int P = omp_get_max_threads();
+    std::vector<Parcial> parciales(P);
+    while(static_cast<int>(locales.size()) < P) locales.emplace_back(alpha);
+
+    const long long bloques = static_cast<long long>((n + kBloque - 1) / kBloque);
+    #pragma omp parallel
+    {
+        const int t = omp_get_thread_num();
+        Parcial& p = parciales[t];
+        p.hist.assign(bins + 2, 0);
+        QuantileSketch& sk = locales[t];
+        sk.clear();
+
+        #pragma omp for schedule(static)
+        for(long long b = 0; b < bloques; ++b){
+            const size_t ini = static_cast<size_t>(b) * kBloque;
+            const int m = static_cast<int>(std::min<size_t>(kBloque, n - ini));
+            const double* x = a + ini;
+
+            double mn = p.mn, mx = p.mx, s = 0.0;
+            #pragma omp simd reduction(min:mn) reduction(max:mx) reduction(+:s)
+            for(int j = 0; j < m; ++j){
+                mn = std::min(mn, x[j]);
+                mx = std::max(mx, x[j]);
+                s += x[j];
+            }
+            const double media_b = s / m;
+            double m2_b = 0.0;
+            #pragma omp simd reduction(+:m2_b)
+            for(int j = 0; j < m; ++j){
+                const double d = x[j] - media_b;
+                m2_b += d * d;
+            }
+            p.mn = mn;
+            p.mx = mx;
+
+            //Chan: combina (cuenta, media, m2) de la hebra con los del bloque
+            const double nt = p.cuenta + m;
+            const double delta = media_b - p.media;
+            p.media += delta * m / nt;
+            p.m2 += m2_b + delta * delta * p.cuenta * m / nt;
+            p.cuenta = nt;
+
+            for(int j = 0; j < m; ++j){
+                const double v = x[j];
+                if(!std::isfinite(v)){      // sin bin ni bucket: se cuentan aparte
+                    ++p.no_finitos;
+                    continue;
+                }
+                int k;
+                if(v < lo) k = 0;
+                else if(v > hi) k = bins + 1;
+                else k = std::min(bins - 1, static_cast<int>((v - lo) * escala)) + 1;
+                ++p.hist[k];
+                sk.add(v);
+            }
+        }
+    }
+
+    //Combinación en orden de hebra
+    Parcial total;
+    QuantileSketch sketch(alpha);
+    for(int t = 0; t < P; ++t){
+        const Parcial& p = parciales[t];
+        if(p.cuenta == 0.0) continue;
+        total.mn = std::min(total.mn, p.mn);
+        total.mx = std::max(total.mx, p.mx);
+        const double nt = total.cuenta + p.cuenta;
+        const double delta = p.media - total.media;
+        total.media += delta * p.cuenta / nt;
+        total.m2 += p.m2 + delta * delta * total.cuenta * p.cuenta / nt;
+        total.cuenta = nt;
+        for(int k = 0; k < bins + 2; ++k) r.histograma[k] += p.hist[k];
+        r.no_finitos += p.no_finitos;
+        sketch.merge(locales[t]);
+    }
+
+    r.min = total.mn;
+    r.max = total.mx;
+    r.media = total.media;
+    r.varianza = total.m2 / total.cuenta;
+    r.cuantiles.reserve(cuantiles.size());
+    for(double q : cuantiles) r.cuantiles.push_back(sketch.quantile(q));
+    return r;
+}
+
+/*
+metodo: open
+descripcion: Abre el archivo de la serie de tiempo (la cabecera se escribe con el primer registro, cuando el
+             rango del histograma ya está fijo)
+retorno: true si se pudo abrir
+*/
+bool DistributionMetrics::open(const std::string& path){
+    out.open(path);
+    if(!out.is_open()){
+        std::cerr << "No se pudo abrir " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+metodo: writeHeader
+descripcion: Escribe la configuración (bins, rango, alpha y cuantiles) y los nombres de las columnas
+retorno: -
+*/
+void DistributionMetrics::writeHeader(){
+    out << "# bins " << bins << " rango " << lo << " " << hi << " alpha " << alpha << " cuantiles";
+    for(double q : cuantiles) out << " " << q;
+    out << "\n# paso tiempo min max media varianza";
+    for(double q : cuantiles) out << " q" << q;
+    out << " bajo";
+    for(int k = 0; k < bins; ++k) out << " h" << k;
+    out << " sobre no_finitos\n";
+}
+
+/*
+metodo: record
+descripcion: Calcula el resumen del estado y lo agrega como una fila de la serie de tiempo
+retorno: -
+*/
+void DistributionMetrics::record(StateView A, double tiempo){
+    const Resumen r = compute(A, tiempo);
+    if(!out.is_open()) return;
+    if(muestras == 0) writeHeader();
+    out << r.paso << std::scientific << std::setprecision(6) << " " << r.tiempo << " " << r.min << " " << r.max
+        << " " << r.media << " " << r.varianza;
+    for(double q : r.cuantiles) out << " " << q;
+    for(uint64_t h : r.histograma) out << " " << h;
+    out << " " << r.no_finitos << std::defaultfloat << "\n";
+    ++muestras;
+}
+
+/*
+metodo: close
+descripcion: Cierra el archivo de la serie de tiempo
+retorno: -
+*/
+void DistributionMetrics::close(){
+    if(out.is_open()) out.close();
+}
+
+/*
+metodo: parseList
+descripcion: Convierte una lista "a,b,c" en un vector de doubles (cuantiles o rango del histograma). Lanza una
+             excepción si algún valor no es un número finito
+retorno: vector con los valores
+*/
+std::vector<double> DistributionMetrics::parseList(const std::string& lista){
+    std::vector<double> out_lista;
+    std::stringstream ss(lista);
+    std::string tok;
+    while(std::getline(ss, tok, ',')){
+        if(tok.empty()) continue;
+        size_t fin = 0;
+        double v = 0.0;
+        try {
+            v = std::stod(tok, &fin);
+        } catch(const std::exception&){
+            fin = 0;
+        }
+        if(fin != tok.size() || !std::isfinite(v)) throw std::runtime_error("Valor invalido en la lista: " + tok);
+        out_lista.push_back(v);
+    }
+    return out_lista;
+}
@@ -0,0 +1,116 @@
+#ifndef DISTRIBUTIONMETRICS_H
+#define DISTRIBUTIONMETRICS_H
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "StateView.h"
+
+/*
+Abstracción:
+Métricas de distribución del campo de amplitudes calculadas en línea: mínimo, máximo, media, varianza, histograma
+de bins fijos y cuantiles aproximados. Los cuantiles se obtienen de un sketch logarítmico (tipo DDSketch) con
+error relativo acotado: cada hebra llena su propio sketch y al final se combinan sumando los conteos. Se registra
+cada cierta cantidad de pasos y se escribe una serie de tiempo compacta en vez de los N valores por paso
+*/
+
+//Sketch de cuantiles con error relativo alpha: |x| cae en el bucket ceil(log_g |x|), con g = (1 + alpha)/(1 - alpha)
+class QuantileSketch{
+public:
+    //Constructor
+    explicit QuantileSketch(double alpha = 0.01);
+
+    //getters
+    uint64_t count() const { return total; }
+    uint64_t nonFinite() const { return no_finitos; }     // NaN e infinitos descartados
+    double getAlpha() const { return alpha; }
+
+    //otros metodos
+    inline void add(double x){
+        if(!std::isfinite(x)){      // log de NaN o infinito no tiene bucket
+            ++no_finitos;
+            return;
+        }
+        const double a = (x < 0.0) ? -x : x;
+        if(a < kMinValor) ++ceros;
+        else if(x > 0.0) ++positivos[indice(a)];
+        else ++negativos[indice(a)];
+        ++total;
+    }
+    void merge(const QuantileSketch& otro);
+    double quantile(double q) const;
+    void clear();
+
+    static constexpr double kMinValor = 1e-12;     // bajo esto el valor se cuenta como cero
+    static constexpr double kMaxValor = 1e12;
+
+private:
+    //datos privados
+    double alpha;
+    double log_g;
+    int buckets;                        // buckets por signo, cubren [kMinValor, kMaxValor]
+    int desplazamiento;                 // índice del bucket de kMinValor
+    std::vector<uint64_t> positivos;
+    std::vector<uint64_t> negativos;
+    uint64_t ceros = 0;
+    uint64_t total = 0;
+    uint64_t no_finitos = 0;
+
+    //otros metodos privados
+    inline int indice(double a) const {
+        const int k = static_cast<int>(std::ceil(std::log(a) / log_g)) - desplazamiento;
+        return k < 0 ? 0 : (k >= buckets ? buckets - 1 : k);
+    }
+    double valor(int k) const;
+};
+
+class DistributionMetrics{
+public:
+    //Resumen de un estado
+    struct Resumen{
+        long long paso = 0;
+        double tiempo = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        double media = 0.0;
+        double varianza = 0.0;
+        std::vector<uint64_t> histograma;      // bins + 2: bajo el rango, bins, sobre el rango
+        uint64_t no_finitos = 0;               // NaN e infinitos (fuera del histograma y de los cuantiles)
+        std::vector<double> cuantiles;
+    };
+
+    static constexpr int kBloque = 256;        // elementos por bloque (quedan en L1 entre las dos fases)
+
+    //Constructor: bins del histograma, rango [lo, hi] (si lo == hi se fija con el primer estado) y cuantiles
+    DistributionMetrics(int bins, double lo, double hi, const std::vector<double>& quantiles, double alpha = 0.01);
+
+    //getters
+    const std::vector<double>& getQuantiles() const { return cuantiles; }
+    int getSamples() const { return muestras; }
+
+    //otros metodos
+    Resumen compute(StateView A, double tiempo);
+    bool open(const std::string& path);
+    void record(StateView A, double tiempo);
+    void close();
+
+    static std::vector<double> parseList(const std::string& lista);
+
+private:
+    //datos privados
+    int bins;
+    double lo, hi;
+    std::vector<double> cuantiles;
+    double alpha;
+    std::ofstream out;
+    int muestras = 0;
+    std::vector<QuantileSketch> locales;        // un sketch por hebra, se reutilizan entre registros
+
+    //otros metodos privados
+    void writeHeader();
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
+#include <omp.h>
+
+#include "ExecutionPolicy.h"
+
+static std::atomic<int> modo_global{static_cast<int>(ExecutionPolicy::Mode::Auto)};
+
+/*
+metodo: medirRegion
+descripcion: Costo de abrir y cerrar una región parallel for con p hebras (con su barrera implícita), como el
+             mejor promedio de 5 tandas de 50 regiones
+retorno: microsegundos por región
+*/
+static double medirRegion(int p){
+    std::vector<double> sumidero(p, 0.0);
+    double mejor = 1e300;
+    for(int tanda = 0; tanda < 6; ++tanda){
+        const double t0 = omp_get_wtime();
+        for(int r = 0; r < 50; ++r){
+            #pragma omp parallel for num_threads(p) schedule(static)
+            for(int k = 0; k < p; ++k) sumidero[k] += 1.0;
+        }
+        const double t = (omp_get_wtime() - t0) / 50.0 * 1e6;
+        if(tanda > 0) mejor = std::min(mejor, t);    // la primera tanda solo calienta el pool
+    }
+    return mejor;
+}
+
+/*
+metodo: medirKernel
+descripcion: Costo serial por nodo de un paso de difusión 1D (el mismo patrón de accesos que el kernel de la
+             malla) sobre un arreglo que cabe en caché
+retorno: nanosegundos por nodo
+*/
+static double medirKernel(){
+    const int n = 1 << 14;
+    std::vector<double> a(n, 1.0), b(n, 0.0);
+    a[n / 2] = 2.0;
+    double mejor = 1e300;
+    for(int tanda = 0; tanda < 6; ++tanda){
+        const double t0 = omp_get_wtime();
+        for(int r = 0; r < 20; ++r){
+            for(int i = 1; i < n - 1; ++i){
+                const double A = a[i];
+                b[i] = A + 0.01 * (0.1 * ((a[i - 1] - A) + (a[i + 1] - A)) - 0.01 * A);
+            }
+            a.swap(b);
+        }
+        const double t = (omp_get_wtime() - t0) / (20.0 * n) * 1e9;
+        if(tanda > 0) mejor = std::min(mejor, t);
+    }
+    return mejor;
+}
+
+/*
+metodo: calibration
+descripcion: Mide una vez por proceso (la primera vez que se pide) el costo por nodo del kernel y el costo de
+             una región paralela para 2, 4, ... hebras y el máximo disponible
+retorno: referencia a la calibración
+*/
+const ExecutionPolicy::Calibracion& ExecutionPolicy::calibration(){
+    static const Calibracion c = []{
+        Calibracion r;
+        const int P = omp_get_max_threads();
+        for(int p = 2; p < P; p *= 2) r.hebras.push_back(p);
+        if(P > 1) r.hebras.push_back(P);
+        for(int p : r.hebras) r.overhead_us.push_back(medirRegion(p));
+        r.ns_por_nodo = medirKernel();
+        return r;
+    }();
+    return c;
+}
+
+/*
+metodo: threadsFor
+descripcion: Hebras para un kernel de "nodos" nodos. costo_relativo escala el costo por nodo medido (por ejemplo
+             para kernels con más vecinos por nodo). Solo se consideran cantidades hasta omp_get_max_threads()
+             (dentro de un equipo del barrido de parametros es el tamaño del equipo)
+retorno: 1 para ejecutar en serie, o la cantidad de hebras de la región
+*/
+int ExecutionPolicy::threadsFor(long long nodos, double costo_relativo){
+    const int maximo = omp_get_max_threads();
+    const Mode modo = getMode();
+    if(modo == Mode::Serial || maximo <= 1) return 1;
+    if(modo == Mode::Parallel) return maximo;
+
+    const Calibracion& c = calibration();
+    const double serial_us = static_cast<double>(nodos) * c.ns_por_nodo * costo_relativo * 1e-3;
+    double mejor = serial_us;
+    int hebras = 1;
+    for(size_t k = 0; k < c.hebras.size(); ++k){
+        //Si el máximo actual no fue medido se usa el costo de la siguiente cantidad medida
+        const int p = std::min(c.hebras[k], maximo);
+        const double t = serial_us / p + c.overhead_us[k];
+        if(t < mejor){
+            mejor = t;
+            hebras = p;
+        }
+        if(c.hebras[k] >= maximo) break;
+    }
+    return hebras;
+}
+
+/*
+metodo: setMode
+descripcion: Fija el modo para todo el proceso (auto, serie o siempre paralelo)
+retorno: -
+*/
+void ExecutionPolicy::setMode(Mode mode){
+    modo_global.store(static_cast<int>(mode), std::memory_order_relaxed);
+}
+
+/*
+metodo: getMode
+descripcion: Modo actual
+retorno: el modo
+*/
+ExecutionPolicy::Mode ExecutionPolicy::getMode(){
+    return static_cast<Mode>(modo_global.load(std::memory_order_relaxed));
+}
+
+/*
+metodo: parseMode
+descripcion: Convierte "auto", "serial" o "parallel" en el modo
+retorno: el modo
+*/
+ExecutionPolicy::Mode ExecutionPolicy::parseMode(const std::string& name){
+    if(name == "auto") return Mode::Auto;
+    if(name == "serial") return Mode::Serial;
+    if(name == "parallel") return Mode::Parallel;
+    throw std::runtime_error("Modo de ejecucion desconocido: " + name + " (auto, serial o parallel)");
+}
+
+/*
+metodo: describe
+descripcion: Resumen de la decisión para una red de "nodos" nodos (para mostrar al inicio de la simulación)
+retorno: string con la descripción
+*/
+std::string ExecutionPolicy::describe(long long nodos){
+    const int hebras = threadsFor(nodos);
+    std::ostringstream s;
+    const Mode modo = getMode();
+    s << (modo == Mode::Auto ? "auto" : modo == Mode::Serial ? "serial" : "parallel") << ", "
+      << hebras << (hebras == 1 ? " hebra (serie)" : " hebras");
+    if(modo == Mode::Auto && omp_get_max_threads() > 1){
+        const Calibracion& c = calibration();
+        s << " [kernel " << c.ns_por_nodo << " ns/nodo, region de " << c.hebras.back() << " hebras "
+          << c.overhead_us.back() << " us]";
+    }
+    return s.str();
+}
@@ -0,0 +1,39 @@
+#ifndef EXECUTIONPOLICY_H
+#define EXECUTIONPOLICY_H
+
+#include <string>
+#include <vector>
+
+/*
+Abstracción:
+Política de ejecución por kernel. Abrir una región paralela cuesta del orden de microsegundos, más que recorrer
+una red de cien nodos, así que para redes pequeñas conviene ejecutar en serie o con menos hebras. El costo de
+abrir una región con p hebras y el costo por nodo del kernel se miden una vez por proceso, y para cada kernel se
+elige la cantidad de hebras que minimiza t(p) = N c / p + overhead(p) (1 = serie, sin región paralela)
+*/
+
+class ExecutionPolicy{
+public:
+    enum class Mode{
+        Auto = 0,       // serie, equipo reducido o todas las hebras según la calibración
+        Serial = 1,
+        Parallel = 2    // siempre todas las hebras (comportamiento anterior)
+    };
+
+    //Mediciones de la máquina
+    struct Calibracion{
+        double ns_por_nodo = 0.0;           // costo serial del kernel por nodo
+        std::vector<int> hebras;            // cantidades de hebras medidas (potencias de 2 y el máximo)
+        std::vector<double> overhead_us;    // costo de abrir y cerrar una región con esas hebras
+    };
+
+    //otros metodos
+    static const Calibracion& calibration();
+    static int threadsFor(long long nodos, double costo_relativo = 1.0);
+    static void setMode(Mode mode);
+    static Mode getMode();
+    static Mode parseMode(const std::string& name);
+    static std::string describe(long long nodos);
+};
+
+#endif
@@ -39,21 +39,25 @@ bool FileManagement::openOutFiles(std::ofstream& csv, std::ofstream& wave_dat, s
 /*
 metodo: writeHeader
 descripcion: Escribe los encabezados en los archivos de salida para resultados,
-             evolución de ondas y conservación de energía
+             evolución de ondas y conservación de energía. Si write_nodes es false no se escriben
+             las columnas por nodo (la evolución completa no se guarda)
 retorno: -
 */
 void FileManagement::writeHeader(std::ofstream& csv,
                          std::ofstream& wave_dat,
                          std::ofstream& energy_dat,
-                         int num_nodes){
+                         int num_nodes,
+                         bool write_nodes){
     csv << "Time_Step,energy,avg_amp";
-    wave_dat << "# Time_Step";
-    for (int i = 0; i < num_nodes; ++i) {
-        csv << ",Node_" << i;
-        wave_dat << " Node_" << i; 
+    if(write_nodes){
+        wave_dat << "# Time_Step";
+        for (int i = 0; i < num_nodes; ++i) {
+            csv << ",Node_" << i;
+            wave_dat << " Node_" << i; 
+        }
+        wave_dat << "\n";
     }
     csv << "\n";
-    wave_dat << "\n";
     energy_dat << "# Time_Step energy\n";
 }
 
@@ -66,24 +70,41 @@ void FileManagement::writeInitialState(Network& myNetwork,
                               WavePropagator& propagation,
                               std::ofstream& csv,
                               std::ofstream& wave_dat,
-                              std::ofstream& energy_dat){
-    propagation.calculateEnergy(0);
-    std::vector<double> initial_amplitudes = myNetwork.getCurrentAmplitudes();
-
-    double avg0 = 0.0;
-    for (double v : initial_amplitudes) avg0 += v;
-    if(!initial_amplitudes.empty()) avg0 /= static_cast<double>(initial_amplitudes.size());
-
-    csv << 0 << "," << std::scientific << std::setprecision(6) << propagation.GetEnergy()
-        << "," << std::scientific << std::setprecision(6) << avg0;
-    wave_dat << 0;
-    for (double amp : initial_amplitudes) {
-        csv << "," << std::scientific << std::setprecision(6) << amp;
-        wave_dat << " " << std::scientific << std::setprecision(6) << amp;
+                              std::ofstream& energy_dat,
+                              bool write_nodes){
+    propagation.calculateEnergy(2);
+    writeStep(csv, wave_dat, energy_dat, 0, propagation.GetEnergy(), myNetwork.getStateView(), write_nodes);
+}
+
+/*
+metodo: writeStep
+descripcion: Escribe la fila de un paso (energía, promedio y, si write_nodes, las amplitudes) leyendo el estado
+             directamente desde la vista, sin copiarlo
+retorno: -
+*/
+void FileManagement::writeStep(std::ofstream& csv,
+                               std::ofstream& wave_dat,
+                               std::ofstream& energy_dat,
+                               int step,
+                               double energy,
+                               StateView amplitudes,
+                               bool write_nodes){
+    double avg = 0.0;
+    for (double v : amplitudes) avg += v;
+    if(!amplitudes.empty()) avg /= static_cast<double>(amplitudes.size());
+
+    csv << step << "," << std::scientific << std::setprecision(6) << energy
+        << "," << std::scientific << std::setprecision(6) << avg;
+    if(write_nodes){
+        wave_dat << step;
+        for (double amp : amplitudes) {
+            csv << "," << std::scientific << std::setprecision(6) << amp;
+            wave_dat << " " << std::scientific << std::setprecision(6) << amp;
+        }
+        wave_dat << "\n";
     }
     csv << "\n";
-    wave_dat << "\n";
-    energy_dat << 0 << " " << std::scientific << std::setprecision(6) << propagation.GetEnergy() << "\n";        
+    energy_dat << step << " " << std::scientific << std::setprecision(6) << energy << "\n";
 }
 
 /*
@@ -98,19 +119,78 @@ void FileManagement::finalizeSimulation(double duracion, std::ofstream& csv){
     std::cout << "Datos de evolucion guardados en 'results.csv'." << std::endl;
 }
 
+/*
+metodo: writeSteadyState
+descripcion: Guarda el resultado del monitor de convergencia: tolerancia, paso en que se alcanzó el estado
+             estacionario (0 si no se alcanzó), tiempo y cambio máximo y L2 del último paso
+retorno: -
+*/
+void FileManagement::writeSteadyState(const std::string& path, double tol, int step, const Network& myNetwork){
+    std::ofstream f(path);
+    if(!f.is_open()){
+        std::cerr << "No se pudo abrir " << path << std::endl;
+        return;
+    }
+    f << "# tolerancia paso tiempo cambio_max cambio_l2\n";
+    f << std::scientific << std::setprecision(6) << tol << " " << step << " "
+      << myNetwork.getCurrentTime() << " " << myNetwork.getLastMaxChange() << " "
+      << myNetwork.getLastL2Change() << "\n";
+}
+
+/*
+metodo: writeSteadySolution
+descripcion: Guarda el equilibrio calculado por el solver directo: una cabecera con iteraciones, residuo y tiempo,
+             y luego la amplitud de cada nodo
+retorno: -
+*/
+void FileManagement::writeSteadySolution(const std::string& path, const Network& myNetwork,
+                                         const SteadyStateSolver::Result& res){
+    std::ofstream f(path);
+    if(!f.is_open()){
+        std::cerr << "No se pudo abrir " << path << std::endl;
+        return;
+    }
+    f << "# iteraciones " << res.iterations << " residuo " << std::scientific << std::setprecision(6)
+      << res.residual << " tiempo " << res.seconds << "\n";
+    f << "# nodo amplitud\n";
+    for(int i = 0; i < myNetwork.getSize(); ++i){
+        f << i << " " << myNetwork.getAmplitude(i) << "\n";
+    }
+}
+
+/*
+metodo: writeFastForward
+descripcion: Guarda el estado obtenido con el avance espectral: paso, tiempo y la amplitud de cada nodo
+retorno: -
+*/
+void FileManagement::writeFastForward(const std::string& path, const Network& myNetwork){
+    std::ofstream f(path);
+    if(!f.is_open()){
+        std::cerr << "No se pudo abrir " << path << std::endl;
+        return;
+    }
+    f << "# paso " << myNetwork.getCurrentStep() << " tiempo " << std::scientific << std::setprecision(6)
+      << myNetwork.getCurrentTime() << "\n";
+    f << "# nodo amplitud\n";
+    for(int i = 0; i < myNetwork.getSize(); ++i){
+        f << i << " " << myNetwork.getAmplitude(i) << "\n";
+    }
+}
+
 /*
 metodo: configureExternalSource
-descripcion: Estaba configurando la fuente externa en la red, aquí se tiene varias opciones predefinidas, zero, ajustado, random y senoidal.
+descripcion: Estaba configurando la fuente externa en la red, aquí se tiene varias opciones predefinidas, zero, ajustado, random, senoidal y fuentes puntuales.
 retorno: -
 */
 void FileManagement::configureExternalSource(Network& myNetwork, int num_nodes) {
 
-    enum class SourcePreset { Zero, Fixed, Random, Sine };
+    enum class SourcePreset { Zero, Fixed, Random, Sine, Points };
 
     //constexpr SourcePreset kSource = SourcePreset::Zero;
     constexpr SourcePreset kSource = SourcePreset::Fixed;
     //constexpr SourcePreset kSource = SourcePreset::Random;
     //constexpr SourcePreset kSource = SourcePreset::Sine;
+    //constexpr SourcePreset kSource = SourcePreset::Points;
 
     constexpr double kFixedValue = 0.05;           // Fixed
     constexpr double kRandMin = -0.05;             // Random
@@ -118,6 +198,7 @@ void FileManagement::configureExternalSource(Network& myNetwork, int num_nodes)
     constexpr unsigned kSeed   = 1234;
     constexpr double kAmp   = 0.1;                 // Sine
     constexpr double kOmega = 2.0 * M_PI * 1.0;    // ω = 2πf (f=1 Hz)
+    constexpr double kPointValue = 1.0;            // Points: emisores senoidales en 1/4 y 3/4 de la red
 
     // Aplica la configuración elegida
     switch (kSource) {
@@ -135,5 +216,10 @@ void FileManagement::configureExternalSource(Network& myNetwork, int num_nodes)
         case SourcePreset::Sine:
             myNetwork.setSineSource(kAmp, kOmega);
             break;
+        case SourcePreset::Points:
+            myNetwork.clearPointSources();
+            myNetwork.addPointSource(num_nodes / 4, 0.0, kPointValue, kOmega);
+            myNetwork.addPointSource(3 * num_nodes / 4, 0.0, kPointValue, kOmega);
+            break;
     }
 }
\ No newline at end of file
@@ -2,8 +2,12 @@
 #define FILEMANAGEMENT_H
 
 #include <fstream>
+#include <string>
 #include <vector>
 
+#include "SteadyStateSolver.h"
+#include "StateView.h"
+
 class Network;
 class WavePropagator;
 
@@ -22,15 +26,29 @@ public:
     static void writeHeader(std::ofstream& csv,
                             std::ofstream& wave_dat,
                             std::ofstream& energy_dat,
-                            int num_nodes);
+                            int num_nodes,
+                            bool write_nodes = true);
     
     static void writeInitialState(Network& myNetwork,
                                     WavePropagator& propagation,
                                     std::ofstream& csv,
                                     std::ofstream& wave_dat,
-                                    std::ofstream& energy_dat);
+                                    std::ofstream& energy_dat,
+                                    bool write_nodes = true);
+
+    static void writeStep(std::ofstream& csv,
+                          std::ofstream& wave_dat,
+                          std::ofstream& energy_dat,
+                          int step,
+                          double energy,
+                          StateView amplitudes,
+                          bool write_nodes = true);
 
     static void finalizeSimulation(double duracion, std::ofstream& csv);
+    static void writeSteadyState(const std::string& path, double tol, int step, const Network& myNetwork);
+    static void writeSteadySolution(const std::string& path, const Network& myNetwork,
+                                    const SteadyStateSolver::Result& res);
+    static void writeFastForward(const std::string& path, const Network& myNetwork);
 
     static void configureExternalSource(Network& myNetwork, int num_nodes);
 };
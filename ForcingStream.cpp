@@ -0,0 +1,133 @@
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "ForcingStream.h"
+
+/*
+metodo: ForcingStream
+descripcion: Constructor, mapea el archivo de forzamiento, valida la cabecera y levanta la hebra de precarga
+retorno: -
+*/
+ForcingStream::ForcingStream(const std::string& path) : archivo(path, false) {
+    const uint64_t* cabecera = reinterpret_cast<const uint64_t*>(archivo.data());
+    if(archivo.size() < 3 * sizeof(uint64_t) || cabecera[0] != kMagic){
+        throw std::runtime_error("Archivo de forzamiento invalido: " + path);
+    }
+    num_nodes = cabecera[1];
+    num_steps = cabecera[2];
+    if(num_nodes == 0) throw std::runtime_error("Archivo de forzamiento sin nodos: " + path);
+    //Se compara por división: con una cabecera corrupta el producto N x pasos x 8 podría desbordarse
+    if(num_steps > (archivo.size() - 3 * sizeof(uint64_t)) / sizeof(double) / num_nodes){
+        throw std::runtime_error("Archivo de forzamiento incompleto: " + path);
+    }
+    filas = reinterpret_cast<const double*>(cabecera + 3);
+
+    archivo.advise(0, archivo.size(), MADV_SEQUENTIAL);
+    prefetcher = std::thread(&ForcingStream::prefetchLoop, this);
+}
+
+/*
+metodo: ~ForcingStream
+descripcion: Destructor, detiene la hebra de precarga
+retorno: -
+*/
+ForcingStream::~ForcingStream(){
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        terminar = true;
+    }
+    cv.notify_all();
+    if(prefetcher.joinable()) prefetcher.join();
+}
+
+/*
+metodo: rowOffset
+descripcion: Posición en bytes de la fila del paso dado dentro del archivo
+retorno: offset en bytes
+*/
+size_t ForcingStream::rowOffset(uint64_t step) const {
+    return 3 * sizeof(uint64_t) + step * num_nodes * sizeof(double);
+}
+
+/*
+metodo: row
+descripcion: Fila de forzamiento del paso dado (N valores) y aviso a la hebra auxiliar para que precargue
+             los siguientes. Fuera del rango del archivo no hay forzamiento
+retorno: puntero a la fila o nullptr si el paso está fuera del archivo
+*/
+const double* ForcingStream::row(uint64_t step){
+    if(step >= num_steps) return nullptr;
+    {
+        //Una vez por paso: el candado evita perder el aviso si la hebra auxiliar está por dormirse
+        std::lock_guard<std::mutex> lock(mtx);
+        objetivo.store(step, std::memory_order_relaxed);
+    }
+    cv.notify_one();
+    return filas + step * num_nodes;
+}
+
+/*
+metodo: prefetchLoop
+descripcion: Hebra auxiliar: mantiene cargadas las filas [objetivo, objetivo + kPasosAdelante) y libera
+             las filas que el kernel ya dejó atrás
+retorno: -
+*/
+void ForcingStream::prefetchLoop(){
+    const size_t bytes_fila = num_nodes * sizeof(double);
+    uint64_t cargado = 0;     // primera fila aún no precargada
+    uint64_t liberado = 0;    // primera fila aún no liberada
+
+    std::unique_lock<std::mutex> lock(mtx);
+    while(!terminar){
+        const uint64_t obj = objetivo.load(std::memory_order_relaxed);
+        const uint64_t hasta = std::min<uint64_t>(num_steps, obj + kPasosAdelante);
+
+        if(cargado < obj) cargado = obj;
+        if(cargado < hasta){
+            lock.unlock();
+            archivo.advise(rowOffset(cargado), (hasta - cargado) * bytes_fila, MADV_WILLNEED);
+            archivo.touch(rowOffset(cargado), (hasta - cargado) * bytes_fila);
+            if(obj > liberado + 1){
+                archivo.advise(rowOffset(liberado), (obj - 1 - liberado) * bytes_fila, MADV_DONTNEED);
+                liberado = obj - 1;
+            }
+            lock.lock();
+            cargado = hasta;
+            continue;
+        }
+        //Se duerme hasta que el kernel consuma la mitad de la ventana ya cargada
+        cv.wait(lock, [&]{
+            const uint64_t o = objetivo.load(std::memory_order_relaxed);
+            return terminar || std::min<uint64_t>(num_steps, o + kPasosAdelante / 2) > cargado;
+        });
+    }
+}
+
+/*
+metodo: writeSine
+descripcion: Genera un archivo de forzamiento de ejemplo: S_i(t) = A sin(w t + fase_i), con la fase
+             creciendo a lo largo de los nodos (una onda viajera)
+retorno: -
+*/
+void ForcingStream::writeSine(const std::string& path, uint64_t num_nodes, uint64_t steps,
+                              double dt, double amplitude, double omega){
+    std::ofstream f(path, std::ios::binary);
+    if(!f.is_open()) throw std::runtime_error("No se pudo crear " + path);
+
+    const uint64_t cabecera[3] = {kMagic, num_nodes, steps};
+    f.write(reinterpret_cast<const char*>(cabecera), sizeof(cabecera));
+
+    std::vector<double> fila(num_nodes);
+    for(uint64_t s = 0; s < steps; ++s){
+        const double t = s * dt;
+        for(uint64_t i = 0; i < num_nodes; ++i){
+            fila[i] = amplitude * std::sin(omega * t - 2.0 * M_PI * static_cast<double>(i) / num_nodes);
+        }
+        f.write(reinterpret_cast<const char*>(fila.data()), fila.size() * sizeof(double));
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef FORCINGSTREAM_H
+#define FORCINGSTREAM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "OutOfCore.h"
+
+/*
+Abstracción:
+Forzamiento por nodo variable en el tiempo, S_i(t), leído desde un archivo binario mapeado en memoria
+(una fila de N doubles por paso). Una hebra auxiliar precarga las filas de los próximos pasos y libera las
+ya usadas, para que el kernel no espere al disco
+*/
+
+class ForcingStream{
+public:
+    //Formato: cabecera (magic, N, pasos) seguida de pasos x N doubles
+    static constexpr uint64_t kMagic = 0x3143524657415645ULL;   // "EVAWFRC1"
+    static constexpr int kPasosAdelante = 64;                    // filas que se precargan
+
+    //Constructor
+    explicit ForcingStream(const std::string& path);
+    ~ForcingStream();
+    ForcingStream(const ForcingStream&) = delete;
+    ForcingStream& operator=(const ForcingStream&) = delete;
+
+    //getters
+    uint64_t getNodes() const { return num_nodes; }
+    uint64_t getSteps() const { return num_steps; }
+
+    //otros metodos
+    const double* row(uint64_t step);
+    static void writeSine(const std::string& path, uint64_t num_nodes, uint64_t steps,
+                          double dt, double amplitude, double omega);
+
+private:
+    //datos privados
+    MappedFile archivo;
+    uint64_t num_nodes = 0;
+    uint64_t num_steps = 0;
+    const double* filas = nullptr;
+
+    std::thread prefetcher;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::atomic<uint64_t> objetivo{0};   // último paso pedido por el kernel
+    bool terminar = false;
+
+    //otros metodos privados
+    void prefetchLoop();
+    size_t rowOffset(uint64_t step) const;
+};
+
+#endif
@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "FrameRenderer.h"
+
+/*
+metodo: viridis
+descripcion: Color del mapa viridis para t en [0, 1], interpolando linealmente 9 colores de referencia
+retorno: - (escribe r, g, b)
+*/
+static void viridis(double t, uint8_t& r, uint8_t& g, uint8_t& b){
+    static const uint8_t tabla[9][3] = {
+        {68, 1, 84}, {71, 45, 123}, {59, 82, 139}, {44, 114, 142}, {33, 145, 140},
+        {40, 174, 128}, {94, 201, 98}, {173, 220, 48}, {253, 231, 37}
+    };
+    t = std::min(1.0, std::max(0.0, t)) * 8.0;
+    const int k = std::min(7, static_cast<int>(t));
+    const double f = t - k;
+    r = static_cast<uint8_t>(tabla[k][0] + f * (tabla[k+1][0] - tabla[k][0]));
+    g = static_cast<uint8_t>(tabla[k][1] + f * (tabla[k+1][1] - tabla[k][1]));
+    b = static_cast<uint8_t>(tabla[k][2] + f * (tabla[k+1][2] - tabla[k][2]));
+}
+
+/*
+metodo: crc32
+descripcion: CRC-32 (polinomio 0xEDB88320) usado por los bloques PNG
+retorno: entero con el CRC
+*/
+static uint32_t crc32(const uint8_t* data, size_t n, uint32_t crc = 0){
+    static uint32_t tabla[256];
+    static bool lista = false;
+    if(!lista){
+        for(uint32_t i = 0; i < 256; ++i){
+            uint32_t c = i;
+            for(int k = 0; k < 8; ++k) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            tabla[i] = c;
+        }
+        lista = true;
+    }
+    crc = ~crc;
+    for(size_t i = 0; i < n; ++i) crc = tabla[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+/*
+metodo: writePng
+descripcion: Escribe una imagen RGB de 8 bits como PNG. El flujo zlib usa bloques deflate sin compresión,
+             así no se depende de librerías externas
+retorno: true si se pudo escribir
+*/
+bool FrameRenderer::writePng(const std::string& path, int w, int h, const std::vector<uint8_t>& rgb){
+    std::ofstream f(path, std::ios::binary);
+    if(!f.is_open()) return false;
+
+    auto be32 = [](std::vector<uint8_t>& v, uint32_t x){
+        v.push_back(x >> 24); v.push_back(x >> 16); v.push_back(x >> 8); v.push_back(x);
+    };
+    auto chunk = [&](const char* tipo, const std::vector<uint8_t>& datos){
+        std::vector<uint8_t> c;
+        be32(c, static_cast<uint32_t>(datos.size()));
+        c.insert(c.end(), tipo, tipo + 4);
+        c.insert(c.end(), datos.begin(), datos.end());
+        be32(c, crc32(c.data() + 4, c.size() - 4));
+        f.write(reinterpret_cast<const char*>(c.data()), c.size());
+    };
+
+    static const uint8_t firma[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+    f.write(reinterpret_cast<const char*>(firma), 8);
+
+    std::vector<uint8_t> ihdr;
+    be32(ihdr, w);
+    be32(ihdr, h);
+    ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0});   // 8 bits, RGB, sin entrelazado
+    chunk("IHDR", ihdr);
+
+    //Datos crudos: un byte de filtro (0) por fila
+    std::vector<uint8_t> crudo;
+    crudo.reserve(static_cast<size_t>(h) * (3 * w + 1));
+    for(int y = 0; y < h; ++y){
+        crudo.push_back(0);
+        crudo.insert(crudo.end(), rgb.begin() + static_cast<size_t>(y) * 3 * w,
+                     rgb.begin() + static_cast<size_t>(y + 1) * 3 * w);
+    }
+
+    //zlib: cabecera, bloques "stored" de hasta 65535 bytes y Adler-32
+    std::vector<uint8_t> z = {0x78, 0x01};
+    size_t pos = 0;
+    do {
+        const size_t n = std::min<size_t>(65535, crudo.size() - pos);
+        z.push_back((pos + n == crudo.size()) ? 1 : 0);
+        z.push_back(n & 0xFF); z.push_back(n >> 8);
+        z.push_back(~n & 0xFF); z.push_back((~n >> 8) & 0xFF);
+        z.insert(z.end(), crudo.begin() + pos, crudo.begin() + pos + n);
+        pos += n;
+    } while(pos < crudo.size());
+    uint32_t a = 1, b = 0;
+    for(uint8_t x : crudo){ a = (a + x) % 65521; b = (b + a) % 65521; }
+    be32(z, (b << 16) | a);
+    chunk("IDAT", z);
+    chunk("IEND", {});
+    f.flush();
+    return static_cast<bool>(f);
+}
+
+/*
+metodo: FrameRenderer
+descripcion: Constructor, crea la carpeta de salida y levanta la hebra de renderizado
+retorno: -
+*/
+FrameRenderer::FrameRenderer(const std::string& dir, int width, int height, double vmin, double vmax,
+                             size_t max_queue)
+    : dir(dir), ancho(width), alto(height), vmin(vmin), vmax(vmax),
+      rango_auto(vmin == vmax), max_cola(std::max<size_t>(1, max_queue))
+{
+    std::filesystem::create_directories(dir);
+    worker = std::thread(&FrameRenderer::loop, this);
+}
+
+/*
+metodo: ~FrameRenderer
+descripcion: Destructor, termina de escribir los cuadros pendientes
+retorno: -
+*/
+FrameRenderer::~FrameRenderer(){
+    finish();
+}
+
+/*
+metodo: queueDepth
+descripcion: Cantidad de cuadros esperando ser renderizados
+retorno: entero con el largo de la cola
+*/
+size_t FrameRenderer::queueDepth(){
+    std::lock_guard<std::mutex> lock(mtx);
+    return cola.size();
+}
+
+/*
+metodo: submit
+descripcion: Copia el estado y lo encola. Si la cola está llena se espera (la escritura marca el ritmo)
+retorno: -
+*/
+void FrameRenderer::submit(int step, StateView A){
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [&]{ return cola.size() < max_cola; });
+    cola.push_back(Frame{step, A.toVector()});
+    cv.notify_all();
+}
+
+/*
+metodo: finish
+descripcion: Espera a que se escriban todos los cuadros y detiene la hebra. Si algún cuadro no se pudo escribir
+             lo informa una vez por stderr
+retorno: -
+*/
+void FrameRenderer::finish(){
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        terminar = true;
+    }
+    cv.notify_all();
+    if(!worker.joinable()) return;
+    worker.join();
+    if(fallidos > 0){
+        std::cerr << "Aviso: no se pudieron escribir " << fallidos << " cuadros en '" << dir << "'" << std::endl;
+    }
+}
+
+/*
+metodo: updateRange
+descripcion: Expande el rango de colores con los valores del cuadro (solo en modo automático)
+retorno: -
+*/
+void FrameRenderer::updateRange(const std::vector<double>& A){
+    if(!rango_auto || A.empty()) return;
+    auto mm = std::minmax_element(A.begin(), A.end());
+    if(vmin == vmax){
+        vmin = *mm.first;
+        vmax = *mm.second;
+    } else {
+        vmin = std::min(vmin, *mm.first);
+        vmax = std::max(vmax, *mm.second);
+    }
+    if(vmin == vmax){
+        vmin -= 1e-6;
+        vmax += 1e-6;
+    }
+}
+
+/*
+metodo: render2D
+descripcion: Imagen de la malla con cada nodo como un bloque de escala x escala pixeles (mínimo ~400 px)
+retorno: vector RGB de la imagen (w y h quedan con su tamaño)
+*/
+std::vector<uint8_t> FrameRenderer::render2D(const std::vector<double>& A, int& w, int& h) const {
+    const int escala = std::max(1, 400 / std::max(ancho, alto));
+    w = ancho * escala;
+    h = alto * escala;
+    std::vector<uint8_t> rgb(static_cast<size_t>(w) * h * 3);
+    const double inv = 1.0 / (vmax - vmin);
+
+    for(int r = 0; r < alto; ++r){
+        for(int c = 0; c < ancho; ++c){
+            uint8_t R, G, B;
+            viridis((A[static_cast<size_t>(r) * ancho + c] - vmin) * inv, R, G, B);
+            for(int dy = 0; dy < escala; ++dy){
+                uint8_t* p = &rgb[((static_cast<size_t>(r) * escala + dy) * w + static_cast<size_t>(c) * escala) * 3];
+                for(int dx = 0; dx < escala; ++dx){
+                    p[3*dx] = R; p[3*dx + 1] = G; p[3*dx + 2] = B;
+                }
+            }
+        }
+    }
+    return rgb;
+}
+
+/*
+metodo: render1D
+descripcion: Gráfico de línea de las amplitudes (eje horizontal = nodo) sobre fondo blanco con el eje en cero
+retorno: vector RGB de la imagen (w y h quedan con su tamaño)
+*/
+std::vector<uint8_t> FrameRenderer::render1D(const std::vector<double>& A, int& w, int& h) const {
+    w = 640;
+    h = 240;
+    const int margen = 10;
+    std::vector<uint8_t> rgb(static_cast<size_t>(w) * h * 3, 255);
+
+    auto pixel = [&](int x, int y, uint8_t R, uint8_t G, uint8_t B){
+        if(x < 0 || y < 0 || x >= w || y >= h) return;
+        uint8_t* p = &rgb[(static_cast<size_t>(y) * w + x) * 3];
+        p[0] = R; p[1] = G; p[2] = B;
+    };
+    auto yPix = [&](double v){
+        return margen + static_cast<int>((vmax - v) / (vmax - vmin) * (h - 2 * margen));
+    };
+    auto xPix = [&](size_t i){
+        return margen + static_cast<int>(A.size() > 1 ? (double)i / (A.size() - 1) * (w - 2 * margen) : 0);
+    };
+
+    if(vmin < 0.0 && vmax > 0.0){
+        const int y0 = yPix(0.0);
+        for(int x = margen; x < w - margen; ++x) pixel(x, y0, 180, 180, 180);
+    }
+
+    //Segmentos entre nodos consecutivos (Bresenham)
+    for(size_t i = 0; i + 1 < A.size(); ++i){
+        int x0 = xPix(i), y0 = yPix(A[i]), x1 = xPix(i + 1), y1 = yPix(A[i + 1]);
+        int dx = std::abs(x1 - x0), sx = (x0 < x1) ? 1 : -1;
+        int dy = -std::abs(y1 - y0), sy = (y0 < y1) ? 1 : -1;
+        int err = dx + dy;
+        while(true){
+            pixel(x0, y0, 31, 119, 180);
+            if(x0 == x1 && y0 == y1) break;
+            int e2 = 2 * err;
+            if(e2 >= dy){ err += dy; x0 += sx; }
+            if(e2 <= dx){ err += dx; y0 += sy; }
+        }
+    }
+    return rgb;
+}
+
+/*
+metodo: loop
+descripcion: Hebra de renderizado: saca cuadros de la cola, los dibuja y los escribe como PNG (los que no se pueden
+             escribir se cuentan en fallidos)
+retorno: -
+*/
+void FrameRenderer::loop(){
+    while(true){
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&]{ return terminar || !cola.empty(); });
+            if(cola.empty()) return;
+            frame = std::move(cola.front());
+            cola.pop_front();
+        }
+        cv.notify_all();
+
+        updateRange(frame.data);
+        int w = 0, h = 0;
+        std::vector<uint8_t> rgb = (alto > 1) ? render2D(frame.data, w, h) : render1D(frame.data, w, h);
+
+        char nombre[32];
+        std::snprintf(nombre, sizeof(nombre), "frame_%06d.png", frame.step);
+        if(writePng(dir + "/" + nombre, w, h, rgb)) ++escritos;
+        else ++fallidos;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef FRAMERENDERER_H
+#define FRAMERENDERER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "StateView.h"
+
+/*
+Abstracción:
+Renderizado de cuadros durante la simulación. Las mallas 2D se dibujan como imagen con mapa de colores viridis
+y las redes 1D como gráfico de línea. Los cuadros se copian a una cola y una hebra en segundo plano los
+convierte en PNG (datos/frames/frame_XXXXXX.png), así la simulación no espera a la escritura
+*/
+
+class FrameRenderer{
+public:
+    //Constructor: ancho y alto de la malla (alto = 1 para redes 1D). Si vmin == vmax el rango de colores
+    //se ajusta automáticamente y solo se expande, para que la animación no parpadee
+    FrameRenderer(const std::string& dir, int width, int height, double vmin = 0.0, double vmax = 0.0,
+                  size_t max_queue = 8);
+    ~FrameRenderer();
+    FrameRenderer(const FrameRenderer&) = delete;
+    FrameRenderer& operator=(const FrameRenderer&) = delete;
+
+    //getters
+    size_t queueDepth();
+    int framesWritten() const { return escritos; }
+    int framesFailed() const { return fallidos; }
+
+    //otros metodos
+    void submit(int step, StateView A);
+    void finish();
+
+    static bool writePng(const std::string& path, int w, int h, const std::vector<uint8_t>& rgb);
+
+private:
+    //Cuadro pendiente de renderizar
+    struct Frame{
+        int step;
+        std::vector<double> data;
+    };
+
+    //datos privados
+    std::string dir;
+    int ancho;
+    int alto;
+    double vmin;
+    double vmax;
+    bool rango_auto;
+    size_t max_cola;
+    std::atomic<int> escritos{0};
+    std::atomic<int> fallidos{0};           // cuadros que writePng no pudo escribir
+
+    std::deque<Frame> cola;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool terminar = false;
+    std::thread worker;
+
+    //otros metodos privados
+    void loop();
+    void updateRange(const std::vector<double>& A);
+    std::vector<uint8_t> render2D(const std::vector<double>& A, int& w, int& h) const;
+    std::vector<uint8_t> render1D(const std::vector<double>& A, int& w, int& h) const;
+};
+
+#endif
@@ -1,13 +1,15 @@
 #include "MetricsCalculator.h"
+#include "ExecutionPolicy.h"
 #include <numeric>
 #include <cmath>
+#include <algorithm>
 
 /*
 metodo: CalcularEnergia
 descripcion: Calcula la energia total del sistema
 retorno: double que representa la energia
 */
-double MetricsCalculator::CalcularEnergia(const std::vector<double>& A){
+double MetricsCalculator::CalcularEnergia(StateView A){
     double e = 0.0;
     for(double x : A) e += x * x;
     return e;
@@ -18,8 +20,86 @@ metodo: CalcularPromedio
 descripcion: Obtien el promedio de las amplitudes
 retorno: double que representa el promedio
 */
-double MetricsCalculator::CalcularPromedio(const std::vector<double>& A){
+double MetricsCalculator::CalcularPromedio(StateView A){
     if(A.empty()) return 0.0;
     double s = std::accumulate(A.begin(), A.end(), 0.0);
     return s / static_cast<double>(A.size());
-}
\ No newline at end of file
+}
+
+/*
+metodo: sumaBloque
+descripcion: Suma (o suma de cuadrados) de a[b, e) con 8 carriles fijos: el carril l acumula los elementos
+             b+l, b+l+8, ...; luego los carriles se combinan en un árbol fijo. El orden de las operaciones
+             no depende de las hebras y el loop interno se puede vectorizar sin reasociar
+retorno: double con la suma del bloque
+*/
+template <bool Cuadrado>
+static double sumaBloque(const double* a, size_t b, size_t e){
+    double carril[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    size_t j = b;
+    for(; j + 8 <= e; j += 8){
+        #pragma omp simd
+        for(int l = 0; l < 8; ++l){
+            const double x = a[j + l];
+            carril[l] += Cuadrado ? x * x : x;
+        }
+    }
+    for(int l = 0; j < e; ++j, ++l){
+        const double x = a[j];
+        carril[l] += Cuadrado ? x * x : x;
+    }
+    return ((carril[0] + carril[1]) + (carril[2] + carril[3]))
+         + ((carril[4] + carril[5]) + (carril[6] + carril[7]));
+}
+
+/*
+metodo: sumaReproducible
+descripcion: Divide el arreglo en bloques de tamaño fijo (kBloqueReproducible), suma cada bloque en paralelo
+             y combina las sumas parciales con un árbol por pares de forma fija. Como la forma de los bloques
+             y del árbol solo depende de n, el resultado es idéntico con 1 u 8 hebras
+retorno: double con la suma
+*/
+template <bool Cuadrado>
+static double sumaReproducible(StateView A){
+    const size_t n = A.size();
+    if(n == 0) return 0.0;
+    const size_t B = MetricsCalculator::kBloqueReproducible;
+    const long long bloques = static_cast<long long>((n + B - 1) / B);
+    const double* a = A.data();
+
+    std::vector<double> parcial(bloques);
+    const int hebras = (bloques > 1) ? ExecutionPolicy::threadsFor(static_cast<long long>(n)) : 1;
+    #pragma omp parallel for schedule(static) if(hebras > 1) num_threads(hebras)
+    for(long long k = 0; k < bloques; ++k){
+        const size_t b = static_cast<size_t>(k) * B;
+        parcial[k] = sumaBloque<Cuadrado>(a, b, std::min(n, b + B));
+    }
+
+    //Árbol por pares: en cada nivel se suman los pares (2i, 2i+1)
+    size_t m = parcial.size();
+    while(m > 1){
+        const size_t mitad = m / 2;
+        for(size_t i = 0; i < mitad; ++i) parcial[i] = parcial[2*i] + parcial[2*i + 1];
+        if(m % 2 == 1) parcial[mitad] = parcial[m - 1];
+        m = mitad + (m % 2);
+    }
+    return parcial[0];
+}
+
+/*
+metodo: CalcularEnergiaReproducible
+descripcion: Energía total (suma de A^2) con reducción reproducible para cualquier cantidad de hebras
+retorno: double que representa la energia
+*/
+double MetricsCalculator::CalcularEnergiaReproducible(StateView A){
+    return sumaReproducible<true>(A);
+}
+
+/*
+metodo: CalcularSumaReproducible
+descripcion: Suma de las amplitudes con reducción reproducible para cualquier cantidad de hebras
+retorno: double con la suma
+*/
+double MetricsCalculator::CalcularSumaReproducible(StateView A){
+    return sumaReproducible<false>(A);
+}
@@ -1,4 +1,10 @@
+#ifndef METRICSCALCULATOR_H
+#define METRICSCALCULATOR_H
+
 #include <vector>
+#include <cstddef>
+
+#include "StateView.h"
 
 /*
 Abstracción:
@@ -8,12 +14,19 @@ Clase creada para calcular el comportaaaamiento de la energia a través del tiem
 class MetricsCalculator{
 public:
     //otros metodos
-    static double CalcularEnergia(const std::vector<double>& A);
-    static double CalcularPromedio(const std::vector<double>& A);
+    static double CalcularEnergia(StateView A);
+    static double CalcularPromedio(StateView A);
+
+    //Reducciones reproducibles: el resultado es el mismo (bit a bit) para cualquier cantidad de hebras
+    static constexpr size_t kBloqueReproducible = 1024;
+    static double CalcularEnergiaReproducible(StateView A);
+    static double CalcularSumaReproducible(StateView A);
 private:
     //datos privados
     double tiempo;
     double energia;
     double amplitudPromedio;
 
-};
\ No newline at end of file
+};
+
+#endif
@@ -1,16 +1,29 @@
+#include <sys/resource.h>
+
 #include <random>
 #include <algorithm> 
 #include <iostream>
 #include <stdexcept>
 #include <vector>
 #include <cmath>
+#include <type_traits>
+#include <utility>
+#include <mutex>
+#include <cstdint>
+#include <omp.h>
 
 #include "Network.h"
+#include "ForcingStream.h"
+#include "SpectralFastForward.h"
+#include "ArrivalTracker.h"
+#include "ExecutionPolicy.h"
+#include "SellCSigma.h"
 
 //Funciones de network
 /*
 metodo: Network
-descripcion: Es el constructor de la clase Network
+descripcion: Es el constructor de la clase Network. Solo reserva el estado (amplitudes y fuentes),
+             la topología se define al inicializar la red
 retorno: -
 */
 Network::Network(int size, double diff_coeff, double damp_coeff) 
@@ -26,57 +39,326 @@ Network::Network(int size, double diff_coeff, double damp_coeff)
         source_amplitude(0.0),
         source_omega(0.0)
 {
-        nodes.reserve(network_size);
-        for(int i = 0; i < network_size; ++i){
-            nodes.emplace_back(i, 0.0);
-        }
-        sources.assign(network_size, 0.0);
+        amplitudes.assign(network_size, 0.0);
+        previous_amplitudes.assign(network_size, 0.0);
         scratch_amplitudes.assign(network_size, 0.0);
+        sources.assign(network_size, 0.0);
 }
 
 /*
 metodo: initializeRegularNetwork
-descripcion: Inicializa la red, puede ser 1D o 2D
+descripcion: Inicializa la red como malla regular 1D (cadena), 2D (w x h) o 3D (w x h x d, estencil de 6 puntos),
+             con bordes abiertos o periódicos. La topología es implícita: no se guardan listas de vecinos
 retorno: -
 */
-void Network::initializeRegularNetwork(int dimensions, int w, int h){
+void Network::initializeRegularNetwork(int dimensions, int w, int h, int d, Boundary bc){
     if (dimensions == 1){
 
         //Como es unidimensional, sera lineal
-        for (int i = 0; i < network_size; ++i) {
-            if (i > 0) nodes[i].addNeighbor(i - 1);
-            if (i < network_size - 1) nodes[i].addNeighbor(i + 1);
-        }
+        w = network_size;
+        h = 1;
+        d = 1;
 
     }else if (dimensions == 2){
         if(h*w != network_size){
             throw std::runtime_error("Dimensiones erroneas");
         }
-
-        //Definimos el alto y el largo
-        alto_malla = h;
-        ancho_malla = w;
-
-        //Hasta 4 vecinos posiblemente conectados
-        auto idx = [w](int r, int c){return r*w+c; };
-        for(int r = 0; r < alto_malla; ++r){
-            for(int c = 0; c < ancho_malla; ++c){
-                int id = idx(r,c);
-                if (r > 0) nodes[id].addNeighbor(idx(r-1,c));
-                if (r < alto_malla - 1) nodes[id].addNeighbor(idx(r+1,c));
-                if (c > 0) nodes[id].addNeighbor(idx(r,c-1));
-                if (c < ancho_malla - 1) nodes[id].addNeighbor(idx(r,c+1));
-            }
+        d = 1;
+    }else if (dimensions == 3){
+        if((long long)w*h*d != network_size){
+            throw std::runtime_error("Dimensiones erroneas");
         }
     } else {
-        throw std::runtime_error("Solo se soporta 2 dimensiones...");
+        throw std::runtime_error("Solo se soporta 1, 2 o 3 dimensiones...");
     }
 
+    //Definimos el ancho, el alto y la profundidad
+    dimensiones = dimensions;
+    ancho_malla = w;
+    alto_malla = h;
+    profundidad_malla = d;
+    boundary = bc;
+
+    //La malla no usa la lista explícita de nodos
+    std::vector<Node>().swap(nodes);
+
+    initialized = true;
+    current_time = 0.0;
+    current_step = 0;
+    ++state_version;
+    scratch_amplitudes.assign(network_size, 0.0);
+}
+
+/*
+metodo: resetExplicitTopology
+descripcion: Deja la red como topología explícita con N nodos aislados, lista para que un generador agregue aristas
+retorno: -
+*/
+void Network::resetExplicitTopology(){
+    sell_valida = false;
+    nodes.clear();
+    nodes.reserve(network_size);
+    for(int i = 0; i < network_size; ++i) nodes.emplace_back(i);
+    dimensiones = 0;
+    ancho_malla = alto_malla = profundidad_malla = 0;
+    pending_updates.clear();
+    removed_nodes.clear();
     initialized = true;
     current_time = 0.0;
+    current_step = 0;
+    ++state_version;
     scratch_amplitudes.assign(network_size, 0.0);
 }
 
+/*
+metodo: initializeRandomNetwork
+descripcion: Red aleatoria de Erdős–Rényi con grado medio 6
+retorno: -
+*/
+void Network::initializeRandomNetwork(){
+    initializeRandomNetwork(network_size > 1 ? std::min(1.0, 6.0 / (network_size - 1)) : 0.0);
+}
+
+/*
+metodo: initializeRandomNetwork
+descripcion: Red aleatoria de Erdős–Rényi: cada par de nodos se conecta con probabilidad p. Se recorren los pares
+             saltando geométricamente entre aristas (Batagelj y Brandes), así el costo es O(N + E) y no O(N^2)
+retorno: -
+*/
+void Network::initializeRandomNetwork(double connection_probability, unsigned int seed){
+    resetExplicitTopology();
+    const double p = connection_probability;
+    if(p <= 0.0 || network_size < 2) return;
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    const double log_q = std::log1p(-std::min(p, 1.0 - 1e-12));
+
+    long long v = 1, w = -1;
+    while(v < network_size){
+        w += 1 + static_cast<long long>(std::floor(std::log1p(-U(rng)) / log_q));
+        while(w >= v && v < network_size){
+            w -= v;
+            ++v;
+        }
+        if(v < network_size){
+            nodes[v].addNeighbor(static_cast<int>(w));
+            nodes[w].addNeighbor(static_cast<int>(v));
+        }
+    }
+}
+
+/*
+metodo: initializeSmallWorldNetwork
+descripcion: Red de mundo pequeño de Watts–Strogatz: anillo donde cada nodo se une a sus k/2 vecinos de cada lado,
+             y cada arista se recablea con probabilidad beta hacia un nodo al azar (sin lazos ni aristas repetidas)
+retorno: -
+*/
+void Network::initializeSmallWorldNetwork(int k, double beta, unsigned int seed){
+    resetExplicitTopology();
+    const int N = network_size;
+    const int mitad = std::max(1, k / 2);
+    if(N < 2 * mitad + 2){
+        throw std::runtime_error("Mundo pequeño: se necesitan al menos k + 2 nodos");
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    std::uniform_int_distribution<int> nodo(0, N - 1);
+
+    for(int j = 1; j <= mitad; ++j){
+        for(int i = 0; i < N; ++i){
+            int destino = (i + j) % N;
+            if(U(rng) < beta){
+                int intento = nodo(rng);
+                while(intento == i || nodes[i].isNeighbor(intento)) intento = nodo(rng);
+                destino = intento;
+            } else if(nodes[i].isNeighbor(destino)){
+                continue;
+            }
+            nodes[i].addNeighbor(destino);
+            nodes[destino].addNeighbor(i);
+        }
+    }
+}
+
+/*
+metodo: initializeScaleFreeNetwork
+descripcion: Red libre de escala de Barabási–Albert: parte de un clique de m+1 nodos y cada nodo nuevo se une a m
+             nodos existentes elegidos con probabilidad proporcional a su grado. Los grados siguen una ley de
+             potencia (pocos nodos con muchísimos vecinos), el caso difícil para repartir la carga entre hebras
+retorno: -
+*/
+void Network::initializeScaleFreeNetwork(int m, unsigned int seed){
+    resetExplicitTopology();
+    const int N = network_size;
+    if(m < 1 || N < m + 1){
+        throw std::runtime_error("Libre de escala: se necesitan al menos m + 1 nodos");
+    }
+
+    std::mt19937 rng(seed);
+    std::vector<int> extremos;      // cada nodo aparece una vez por arista: elegir al azar = elegir por grado
+    extremos.reserve(2LL * m * N);
+
+    for(int a = 0; a <= m; ++a){
+        for(int b = a + 1; b <= m; ++b){
+            nodes[a].addNeighbor(b);
+            nodes[b].addNeighbor(a);
+            extremos.push_back(a);
+            extremos.push_back(b);
+        }
+    }
+
+    std::vector<int> elegidos;
+    for(int v = m + 1; v < N; ++v){
+        elegidos.clear();
+        std::uniform_int_distribution<size_t> pick(0, extremos.size() - 1);
+        while((int)elegidos.size() < m){
+            const int u = extremos[pick(rng)];
+            if(std::find(elegidos.begin(), elegidos.end(), u) == elegidos.end()) elegidos.push_back(u);
+        }
+        for(int u : elegidos){
+            nodes[v].addNeighbor(u);
+            nodes[u].addNeighbor(v);
+            extremos.push_back(v);
+            extremos.push_back(u);
+        }
+    }
+}
+
+/*
+metodo: getEdgeCount
+descripcion: Cantidad de aristas no dirigidas (mitad de la suma de los grados)
+retorno: número de aristas
+*/
+long long Network::getEdgeCount() const {
+    long long suma = 0;
+    #pragma omp parallel for schedule(static) reduction(+:suma)
+    for(int i = 0; i < network_size; ++i) suma += getDegree(i);
+    return suma / 2;
+}
+
+/*
+metodo: bloqueAsignado
+descripcion: Tamaño del bloque que entrega malloc (glibc) para un pedido de "bytes": cabecera de 8 bytes,
+             alineación a 16 y mínimo de 32. Sirve para estimar el sobrecosto de muchas listas chicas
+retorno: bytes del bloque (0 si no hay pedido)
+*/
+static size_t bloqueAsignado(size_t bytes){
+    if(bytes == 0) return 0;
+    return std::max<size_t>(32, (bytes + 8 + 15) & ~static_cast<size_t>(15));
+}
+
+/*
+metodo: getMemoryFootprint
+descripcion: Cuenta los bytes reservados por la red separados en topología, estado, fuentes y buffers. En las
+             topologías explícitas cada nodo tiene su propio vector de vecinos, así que también se estima el
+             sobrecosto del asignador, que en grafos de grado bajo puede superar al contenido
+retorno: desglose de la memoria
+*/
+Network::MemoryFootprint Network::getMemoryFootprint() const {
+    MemoryFootprint m;
+    m.nodes = network_size;
+    m.edges = getEdgeCount();
+
+    m.topology = nodes.capacity() * sizeof(Node) + sell.bytes();
+    for(const Node& n : nodes){
+        const size_t bytes = n.getNeighbors().capacity() * sizeof(int);
+        m.topology += bytes;
+        m.allocator += bloqueAsignado(bytes) - bytes;
+    }
+    m.allocator += bloqueAsignado(nodes.capacity() * sizeof(Node)) - nodes.capacity() * sizeof(Node);
+
+    m.state = (amplitudes.capacity() + previous_amplitudes.capacity()) * sizeof(double);
+    m.scratch = scratch_amplitudes.capacity() * sizeof(double);
+    m.sources = sources.capacity() * sizeof(double) + point_sources.capacity() * sizeof(PointSource)
+              + mascara_fuentes.capacity();
+    m.other = pending_updates.capacity() * sizeof(TopologyUpdate) + removed_nodes.capacity();
+    return m;
+}
+
+/*
+metodo: peakRssBytes
+descripcion: Memoria residente máxima del proceso (getrusage)
+retorno: bytes
+*/
+size_t Network::peakRssBytes(){
+    struct rusage uso;
+    if(getrusage(RUSAGE_SELF, &uso) != 0) return 0;
+    return static_cast<size_t>(uso.ru_maxrss) * 1024;   // Linux lo entrega en KiB
+}
+
+/*
+metodo: getDegree
+descripcion: Obtiene el grado del nodo i, ya sea calculado desde la malla o desde la lista de vecinos
+retorno: entero con el grado
+*/
+int Network::getDegree(int i) const {
+    if(!isLattice()) return nodes[i].getDegree();
+
+    const bool periodic = (boundary == Boundary::Periodic);
+    const int x = i % ancho_malla;
+    const int y = (i / ancho_malla) % alto_malla;
+    const int z = i / (ancho_malla * alto_malla);
+
+    int grado = 0;
+    auto eje = [&](int coord, int n){
+        if(n <= 1) return;
+        if(coord > 0 || (periodic && n > 2)) ++grado;
+        if(coord < n - 1 || (periodic && n > 2)) ++grado;
+    };
+    eje(z, profundidad_malla);
+    eje(y, alto_malla);
+    eje(x, ancho_malla);
+    return grado;
+}
+
+/*
+metodo: getNeighbors
+descripcion: Escribe en out los vecinos del nodo i, en el mismo orden que usa el kernel de propagación.
+             En las mallas se calculan desde las coordenadas
+retorno: -
+*/
+void Network::getNeighbors(int i, std::vector<int>& out) const {
+    out.clear();
+    if(!isLattice()){
+        out = nodes[i].getNeighbors();
+        return;
+    }
+
+    const bool periodic = (boundary == Boundary::Periodic);
+    const int x = i % ancho_malla;
+    const int y = (i / ancho_malla) % alto_malla;
+    const int z = i / (ancho_malla * alto_malla);
+
+    auto eje = [&](int coord, int n, int stride){
+        if(n <= 1) return;
+        if(coord > 0)              out.push_back(i - stride);
+        else if(periodic && n > 2) out.push_back(i + (n - 1) * stride);
+        if(coord < n - 1)          out.push_back(i + stride);
+        else if(periodic && n > 2) out.push_back(i - (n - 1) * stride);
+    };
+    eje(z, profundidad_malla, ancho_malla * alto_malla);
+    eje(y, alto_malla, ancho_malla);
+    eje(x, ancho_malla, 1);
+}
+
+/*
+metodo: resetState
+descripcion: Deja todas las amplitudes y el tiempo en cero conservando la topología y los buffers,
+             permite reutilizar una red ya construida para otra simulación
+retorno: -
+*/
+void Network::resetState(){
+    std::fill(amplitudes.begin(), amplitudes.end(), 0.0);
+    std::fill(previous_amplitudes.begin(), previous_amplitudes.end(), 0.0);
+    ++state_version;
+    current_time = 0.0;
+    current_step = 0;
+    ultimo_cambio_max = 0.0;
+    ultimo_cambio_l2 = 0.0;
+}
+
 /*
 metodo: setSources
 descripcion: Define los valores de las fuentes externas
@@ -128,6 +410,64 @@ void Network::setSineSource(double amplitude, double omega){
     source_mode = SourceMode::Sine_uniform;
 }
 
+/*
+metodo: setStreamedSource
+descripcion: Usa como fuente el forzamiento por nodo leído paso a paso desde un ForcingStream.
+             La red no toma posesión del stream, que debe vivir mientras se simula
+retorno: -
+*/
+void Network::setStreamedSource(ForcingStream* stream){
+    if(stream && stream->getNodes() != (uint64_t)network_size){
+        throw std::runtime_error("El archivo de forzamiento no coincide con el numero de nodos");
+    }
+    forcing_stream = stream;
+    forcing_row = nullptr;
+    forcing_nodes = stream ? network_size : 0;
+    forcing_agotado = false;
+    source_mode = stream ? SourceMode::Streamed : SourceMode::Zero;
+}
+
+/*
+metodo: addPointSource
+descripcion: Agrega una fuente puntual en el nodo dado: S(t) = valor + A sin(wt). Cambia al modo Sparse,
+             donde el kernel no lleva término de fuente y las fuentes se suman después en un scatter pequeño
+retorno: -
+*/
+void Network::addPointSource(int node, double value, double amplitude, double omega){
+    if(node < 0 || node >= network_size){
+        throw std::out_of_range("Nodo fuera de rango para la fuente puntual");
+    }
+    point_sources.push_back({node, value, amplitude, omega});
+    mascara_valida = false;
+    source_mode = SourceMode::Sparse;
+}
+
+/*
+metodo: clearPointSources
+descripcion: Elimina todas las fuentes puntuales
+retorno: -
+*/
+void Network::clearPointSources(){
+    point_sources.clear();
+    mascara_valida = false;
+}
+
+/*
+metodo: applyPointSources
+descripcion: Suma el aporte dt*S(t) de cada fuente puntual sobre el nuevo estado. Es lineal en la fuente,
+             así que equivale a incluirla en el kernel pero sin recorrer un vector de N fuentes
+retorno: -
+*/
+void Network::applyPointSources(double* new_amplitude, double t) const {
+    if(source_mode != SourceMode::Sparse) return;
+    for(const PointSource& p : point_sources){
+        if(isRemoved(p.node)) continue;
+        double s = p.value;
+        if(p.omega != 0.0 || p.amplitude != 0.0) s += p.amplitude * std::sin(p.omega * t);
+        new_amplitude[p.node] += time_step * s;
+    }
+}
+
 /*
 metodo: evalSourceTerm
 descripcion: Evalúa el término de la fuente externa en el nodo i y tiempo t
@@ -143,6 +483,8 @@ inline double Network::evalSourceTerm(int i, double t) const {
             return (i < (int)sources.size()) ? sources[i] : 0.0;
         case SourceMode::Sine_uniform:
             return source_amplitude * std::sin(source_omega * t);
+        case SourceMode::Streamed:
+            return (forcing_row && i < forcing_nodes) ? forcing_row[i] : 0.0;
         default:
             return 0.0;
     }
@@ -176,96 +518,580 @@ void Network::propagateWaves(int schedule_type, int chunk_size){
 }
 
 /*
-metodo: propagateCore
-descripcion: Función central que propaga las ondas en la red con diferentes opciones de paralelización
+estructura: CambioPaso
+descripcion: Cambio máximo y suma de cuadrados de los cambios de un paso (monitor de convergencia)
+*/
+struct CambioPaso{
+    double max = 0.0;
+    double suma2 = 0.0;
+};
+
+/*
+metodo: conBool
+descripcion: Convierte una opción en tiempo de ejecución en una constante de compilación (std::true_type o
+             std::false_type), así cada combinación de opciones instancia su propio kernel sin ramas internas
+retorno: lo que devuelva f
+*/
+template <typename F>
+static auto conBool(bool valor, const F& f){
+    return valor ? f(std::true_type{}) : f(std::false_type{});
+}
+
+/*
+metodo: acumular
+descripcion: Ejecuta body(i). Si el cuerpo devuelve el cambio del nodo, lo acumula en el máximo y la suma de cuadrados
 retorno: -
 */
-void Network::propagateCore(int schedule_type, int chunk_size, bool use_chunk){
-    //Vamos a imprimir un mensaje de que entro a la función
-    if(!initialized){
-        std::cerr << "Se llamo la función antes de iniciar\n";
-    }
-    if(time_step <= 0.0){
-        std::cerr << "Los pasos no han sido configurados\n";
-        time_step = 0.01;
+template <typename Body>
+static inline void acumular(const Body& computeBody, int i, double& mx, double& s2){
+    if constexpr (std::is_void_v<decltype(computeBody(i))>) {
+        computeBody(i);
+    } else {
+        const double d = computeBody(i);
+        mx = std::max(mx, std::fabs(d));
+        s2 += d * d;
     }
+}
 
-    //Definimos las variables que vamos a usar
-    const int N = network_size;
-    const double D = diffusion_coeff;
-    const double gamma = damping_coeff;
+/*
+estructura: RangoRobo
+descripcion: Rango de nodos pendiente de una hebra en el ejecutor con robo de trabajo. Cada rango ocupa su propia
+             línea de caché para que los candados de hebras distintas no compartan línea
+*/
+struct alignas(64) RangoRobo{
+    std::mutex mtx;
+    int inicio = 0;
+    int fin = 0;
+};
 
-    std::vector<double> new_amplitude(N, 0.0);
+/*
+metodo: runWorkStealing
+descripcion: Ejecutor con robo de trabajo: cada hebra parte con un bloque contiguo de [0, N) y lo consume de a
+             "grano" nodos desde el inicio. Cuando se queda sin trabajo elige víctimas y les roba la mitad final de
+             su rango pendiente (división de rangos). No hay contador compartido como en dynamic/guided: cada
+             hebra solo toca su propio candado salvo al robar. Como el trabajo solo se divide y nunca se crea, una
+             hebra que no encuentra nada en una vuelta completa por las víctimas puede terminar
+retorno: cambio máximo y suma de cuadrados (igual que runScheduled)
+*/
+template <typename Body>
+static CambioPaso runWorkStealing(int N, int chunk_size, int hebras_max, const Body& computeBody){
+    const int P = hebras_max;
+    const int grano = (chunk_size > 0) ? chunk_size : 64;
+    std::vector<RangoRobo> rangos(P);
+    double mx = 0.0, s2 = 0.0;
 
-    const double t_now = current_time;
+    #pragma omp parallel num_threads(P) reduction(max:mx) reduction(+:s2)
+    {
+        const int tid = omp_get_thread_num();
+        const int hebras = omp_get_num_threads();
+        RangoRobo& propio = rangos[tid];
+        {
+            std::lock_guard<std::mutex> lock(propio.mtx);
+            propio.inicio = static_cast<int>(static_cast<long long>(N) * tid / hebras);
+            propio.fin = static_cast<int>(static_cast<long long>(N) * (tid + 1) / hebras);
+        }
+        #pragma omp barrier
 
-    //Aquí esta el loop principal el cual calcular nuevas amplitudes.
-    auto computeBody = [&](int i){ 
-        const Node& node = nodes[i];
-        double A = node.getAmplitude();
-        double sum_diff = 0.0;
-        for(int nb : node.getNeighbors()){
-            sum_diff += (nodes[nb].getAmplitude() - A);
+        uint32_t semilla = 2654435761u * (tid + 1);
+        while(true){
+            int a = 0, b = 0;
+            {
+                std::lock_guard<std::mutex> lock(propio.mtx);
+                a = propio.inicio;
+                b = std::min(propio.fin, a + grano);
+                propio.inicio = b;
+            }
+            if(a < b){
+                for(int i = a; i < b; ++i) acumular(computeBody, i, mx, s2);
+                continue;
+            }
+
+            //Sin trabajo propio: se recorren las víctimas partiendo de una al azar
+            bool robado = false;
+            semilla = semilla * 1664525u + 1013904223u;
+            const int primera = static_cast<int>(semilla % static_cast<uint32_t>(hebras));
+            for(int k = 0; k < hebras && !robado; ++k){
+                const int v = (primera + k) % hebras;
+                if(v == tid) continue;
+                RangoRobo& victima = rangos[v];
+                int ra = 0, rb = 0;
+                {
+                    std::lock_guard<std::mutex> lock(victima.mtx);
+                    const int restantes = victima.fin - victima.inicio;
+                    if(restantes <= 0) continue;
+                    const int mitad = (restantes > grano) ? victima.inicio + restantes / 2 : victima.inicio;
+                    ra = mitad;
+                    rb = victima.fin;
+                    victima.fin = mitad;
+                }
+                std::lock_guard<std::mutex> lock(propio.mtx);
+                propio.inicio = ra;
+                propio.fin = rb;
+                robado = true;
+            }
+            if(!robado) break;
         }
-        double source_term = evalSourceTerm(i, t_now);
-        double delta = time_step * (D * sum_diff - gamma * A + source_term);
-        new_amplitude[i] = A + delta;
-    };
+    }
+    return {mx, s2};
+}
+
+/*
+metodo: runScheduled
+descripcion: Ejecuta body(i) para i en [0, N) con el schedule de OpenMP pedido (static, dynamic o guided),
+             con o sin chunk explícito, o con el ejecutor propio de robo de trabajo (schedule 3), usando
+             "hebras" hebras (la política de ejecución). Con una hebra se recorre en serie sin abrir una región.
+             Si body devuelve el cambio del nodo, se reduce en el mismo recorrido
+retorno: cambio máximo y suma de cuadrados (cero si body no devuelve nada)
+*/
+template <typename Body>
+static CambioPaso runScheduled(int N, int schedule_type, int chunk_size, bool use_chunk, int hebras,
+                               const Body& computeBody){
+    double mx = 0.0, s2 = 0.0;
+    if (hebras <= 1) {
+        for (int i = 0; i < N; ++i) acumular(computeBody, i, mx, s2);
+        return {mx, s2};
+    }
+    if (schedule_type == 3) return runWorkStealing(N, use_chunk ? chunk_size : 0, hebras, computeBody);
 
-    //Aquí comenzamos la paralelización
     if (use_chunk && chunk_size > 0) {
         switch (schedule_type) {
             case 0: // static, chunk
-                #pragma omp parallel for schedule(static, chunk_size)
-                for (int i = 0; i < N; ++i) computeBody(i);
+                #pragma omp parallel for schedule(static, chunk_size) num_threads(hebras) reduction(max:mx) reduction(+:s2)
+                for (int i = 0; i < N; ++i) acumular(computeBody, i, mx, s2);
                 break;
             case 1: // dynamic, chunk
-                #pragma omp parallel for schedule(dynamic, chunk_size)
-                for (int i = 0; i < N; ++i) computeBody(i);
+                #pragma omp parallel for schedule(dynamic, chunk_size) num_threads(hebras) reduction(max:mx) reduction(+:s2)
+                for (int i = 0; i < N; ++i) acumular(computeBody, i, mx, s2);
                 break;
             case 2: // guided, chunk
-                #pragma omp parallel for schedule(guided, chunk_size)
-                for (int i = 0; i < N; ++i) computeBody(i);
+                #pragma omp parallel for schedule(guided, chunk_size) num_threads(hebras) reduction(max:mx) reduction(+:s2)
+                for (int i = 0; i < N; ++i) acumular(computeBody, i, mx, s2);
                 break;
             default:
-                #pragma omp parallel for schedule(static, chunk_size)
-                for (int i = 0; i < N; ++i) computeBody(i);
+                #pragma omp parallel for schedule(static, chunk_size) num_threads(hebras) reduction(max:mx) reduction(+:s2)
+                for (int i = 0; i < N; ++i) acumular(computeBody, i, mx, s2);
                 break;
         }
     } else {
         switch (schedule_type) {
             case 0: // static
-                #pragma omp parallel for schedule(static)
-                for (int i = 0; i < N; ++i) computeBody(i);
+                #pragma omp parallel for schedule(static) num_threads(hebras) reduction(max:mx) reduction(+:s2)
+                for (int i = 0; i < N; ++i) acumular(computeBody, i, mx, s2);
                 break;
             case 1: // dynamic
-                #pragma omp parallel for schedule(dynamic)
-                for (int i = 0; i < N; ++i) computeBody(i);
+                #pragma omp parallel for schedule(dynamic) num_threads(hebras) reduction(max:mx) reduction(+:s2)
+                for (int i = 0; i < N; ++i) acumular(computeBody, i, mx, s2);
                 break;
             case 2: // guided
-                #pragma omp parallel for schedule(guided)
-                for (int i = 0; i < N; ++i) computeBody(i);
+                #pragma omp parallel for schedule(guided) num_threads(hebras) reduction(max:mx) reduction(+:s2)
+                for (int i = 0; i < N; ++i) acumular(computeBody, i, mx, s2);
                 break;
             default:
-                #pragma omp parallel for schedule(static)
-                for (int i = 0; i < N; ++i) computeBody(i);
+                #pragma omp parallel for schedule(static) num_threads(hebras) reduction(max:mx) reduction(+:s2)
+                for (int i = 0; i < N; ++i) acumular(computeBody, i, mx, s2);
                 break;
         }
     }
+    return {mx, s2};
+}
+
+/*
+metodo: latticeDiffSum
+descripcion: Suma de (A_vecino - A) para el nodo i de una malla regular W x H x Dp, calculando los vecinos
+             desde las coordenadas. El orden (z, y, x) mantiene el mismo orden de suma que las listas de vecinos
+             de la versión explícita. Con bordes periódicos y un eje de largo 2 no se duplica la arista
+retorno: double con la suma
+*/
+static inline double latticeDiffSum(const double* a, int i, int W, int H, int Dp, bool periodic){
+    const double A = a[i];
+    const int x = i % W;
+    const int y = (i / W) % H;
+    const int z = i / (W * H);
+    double sum_diff = 0.0;
 
-    // Fase de escritura separada
-    #pragma omp parallel for schedule(static)
-    for (int i = 0; i < N; ++i){
-        nodes[i].setPreviousAmplitude(nodes[i].getAmplitude());
-        nodes[i].setAmplitude(new_amplitude[i]);
+    auto eje = [&](int coord, int n, int stride){
+        if(n <= 1) return;
+        if(coord > 0)                  sum_diff += (a[i - stride] - A);
+        else if(periodic && n > 2)     sum_diff += (a[i + (n - 1) * stride] - A);
+        if(coord < n - 1)              sum_diff += (a[i + stride] - A);
+        else if(periodic && n > 2)     sum_diff += (a[i - (n - 1) * stride] - A);
+    };
+    eje(z, Dp, W * H);
+    eje(y, H, W);
+    eje(x, W, 1);
+    return sum_diff;
+}
+
+/*
+metodo: runSmallLattice
+descripcion: Kernel serial especializado para mallas pequeñas (cuando la política elige una sola hebra). Recorre
+             la malla por filas: los nodos interiores calculan sus vecinos con desplazamientos fijos, sin divisiones
+             ni ramas de borde, y solo los nodos de borde usan latticeDiffSum. El orden de suma es el mismo
+             (z, y, x), así el resultado es idéntico bit a bit al del kernel general
+retorno: cambio máximo y suma de cuadrados (igual que runScheduled)
+*/
+template <typename Nodo>
+static CambioPaso runSmallLattice(const double* a, int W, int H, int Dp, bool periodic, const Nodo& nodo){
+    double mx = 0.0, s2 = 0.0;
+    const int WH = W * H;
+    for(int z = 0; z < Dp; ++z){
+        const bool interior_z = (Dp <= 1) || (z > 0 && z < Dp - 1);
+        for(int y = 0; y < H; ++y){
+            const int base = z * WH + y * W;
+            const bool interior = interior_z && ((H <= 1) || (y > 0 && y < H - 1)) && W >= 3;
+            if(!interior){
+                for(int i = base; i < base + W; ++i){
+                    const double sum_diff = latticeDiffSum(a, i, W, H, Dp, periodic);
+                    acumular([&](int j){ return nodo(j, sum_diff); }, i, mx, s2);
+                }
+                continue;
+            }
+            const double borde_izq = latticeDiffSum(a, base, W, H, Dp, periodic);
+            acumular([&](int j){ return nodo(j, borde_izq); }, base, mx, s2);
+            for(int i = base + 1; i < base + W - 1; ++i){
+                const double A = a[i];
+                double sum_diff = 0.0;
+                if(Dp > 1){ sum_diff += (a[i - WH] - A); sum_diff += (a[i + WH] - A); }
+                if(H > 1){ sum_diff += (a[i - W] - A); sum_diff += (a[i + W] - A); }
+                sum_diff += (a[i - 1] - A);
+                sum_diff += (a[i + 1] - A);
+                acumular([&](int j){ return nodo(j, sum_diff); }, i, mx, s2);
+            }
+            const double borde_der = latticeDiffSum(a, base + W - 1, W, H, Dp, periodic);
+            acumular([&](int j){ return nodo(j, borde_der); }, base + W - 1, mx, s2);
+        }
+    }
+    return {mx, s2};
+}
+
+/*
+metodo: runSell
+descripcion: Kernel de topologías explícitas sobre la representación SELL-C-sigma: cada iteración toma un tramo de
+             kC nodos, calcula sus sumas de vecinos en paralelo SIMD (un gather por columna) y luego aplica la
+             actualización de cada nodo. Con schedule distinto de static los tramos se reparten de a 16 en forma
+             dinámica (los tramos de nodos de grado alto son más anchos)
+retorno: cambio máximo y suma de cuadrados (igual que runScheduled)
+*/
+template <typename Nodo>
+static CambioPaso runSell(const SellCSigma& m, const double* a, double* new_amplitude, const char* removed,
+                          int hebras, bool estatico, const Nodo& nodo){
+    constexpr int C = SellCSigma::kC;
+    const int S = m.getSlices();
+    double mx = 0.0, s2 = 0.0;
+    auto tramo = [&](int s, double& mx_l, double& s2_l){
+        const int* filas = m.rows(s);
+        double A[C], suma[C];
+        for(int l = 0; l < C; ++l) A[l] = (filas[l] >= 0) ? a[filas[l]] : 0.0;
+        SellCSigma::sliceSums(a, m.columns(s), m.width(s), A, suma);
+        for(int l = 0; l < C; ++l){
+            const int i = filas[l];
+            if(i < 0) continue;
+            if(removed && removed[i]){
+                new_amplitude[i] = 0.0;
+                continue;
+            }
+            acumular([&](int j){ return nodo(j, suma[l]); }, i, mx_l, s2_l);
+        }
+    };
+    if(estatico){
+        #pragma omp parallel for schedule(static) if(hebras > 1) num_threads(hebras) \
+            reduction(max:mx) reduction(+:s2)
+        for(int s = 0; s < S; ++s) tramo(s, mx, s2);
+    } else {
+        #pragma omp parallel for schedule(dynamic, 16) if(hebras > 1) num_threads(hebras) \
+            reduction(max:mx) reduction(+:s2)
+        for(int s = 0; s < S; ++s) tramo(s, mx, s2);
+    }
+    return {mx, s2};
+}
+
+/*
+metodo: propagateCore
+descripcion: Función central que propaga las ondas en la red con diferentes opciones de paralelización
+retorno: -
+*/
+void Network::propagateCore(int schedule_type, int chunk_size, bool use_chunk){
+    //Vamos a imprimir un mensaje de que entro a la función
+    if(!initialized){
+        std::cerr << "Se llamo la función antes de iniciar\n";
+    }
+    if(time_step <= 0.0){
+        std::cerr << "Los pasos no han sido configurados\n";
+        time_step = 0.01;
+    }
+
+    //Cambios de topología encolados desde el paso anterior
+    if(!pending_updates.empty()) commitTopology();
+
+    //Definimos las variables que vamos a usar
+    const int N = network_size;
+    const double D = diffusion_coeff;
+    const double gamma = damping_coeff;
+
+    //Se escribe en el buffer de la red en vez de reservar memoria en cada paso
+    if((int)scratch_amplitudes.size() != N) scratch_amplitudes.assign(N, 0.0);
+    double* new_amplitude = scratch_amplitudes.data();
+    const double* a = amplitudes.data();
+
+    const double t_now = current_time;
+    beginStep();
+
+    //Aquí esta el loop principal el cual calcular nuevas amplitudes. Sin fuente densa (Zero o Sparse)
+    //se instancia el kernel sin término de fuente, con el monitor de convergencia cada nodo devuelve su cambio
+    //y con el seguimiento de llegadas cada nodo registra su nuevo valor
+    const char* en_fuente = ((monitor_convergencia || arrival_tracker) && source_mode == SourceMode::Sparse)
+                            ? pointSourceMask() : nullptr;
+    ArrivalTracker* tracker = arrival_tracker;
+    const int paso = static_cast<int>(current_step + 1);
+
+    //Política de ejecución: serie, equipo reducido o todas las hebras según el tamaño de la red. Las listas
+    //explícitas cuestan aproximadamente el doble por nodo que la malla (indirección de vecinos)
+    const int hebras = ExecutionPolicy::threadsFor(N, isLattice() ? 1.0 : 2.0);
+
+    //Con la representación SELL-C-sigma activa se reconstruye después de cualquier cambio de topología
+    if(usar_sell && !isLattice() && !sell_valida){
+        sell.build(nodes);
+        sell_valida = true;
     }
 
+    auto kernel = [&](auto con_fuente, auto monitor, auto seguimiento){
+        constexpr bool kMonitor = decltype(monitor)::value;
+        constexpr bool kSeguimiento = decltype(seguimiento)::value;
+        //Actualización de un nodo dada su suma de (A_vecino - A), común a todas las topologías
+        auto nodo = [&](int i, double sum_diff){
+            double A = a[i];
+            double source_term = 0.0;
+            if constexpr (decltype(con_fuente)::value) source_term = evalSourceTerm(i, t_now);
+            double delta = time_step * (D * sum_diff - gamma * A + source_term);
+            new_amplitude[i] = A + delta;
+            if constexpr (kSeguimiento) if(!(en_fuente && en_fuente[i])) tracker->update(i, A + delta, paso);
+            if constexpr (kMonitor) return (en_fuente && en_fuente[i]) ? 0.0 : delta;
+        };
+        if(isLattice()){
+            const int W = ancho_malla, H = alto_malla, Dp = profundidad_malla;
+            const bool periodic = (boundary == Boundary::Periodic);
+            if(hebras <= 1) return runSmallLattice(a, W, H, Dp, periodic, nodo);
+            return runScheduled(N, schedule_type, chunk_size, use_chunk, hebras, [&](int i){
+                return nodo(i, latticeDiffSum(a, i, W, H, Dp, periodic));
+            });
+        }
+        const char* removed = removed_nodes.empty() ? nullptr : removed_nodes.data();
+        if(usar_sell) return runSell(sell, a, new_amplitude, removed, hebras, schedule_type == 0, nodo);
+        return runScheduled(N, schedule_type, chunk_size, use_chunk, hebras, [&](int i){
+            if(removed && removed[i]){
+                new_amplitude[i] = 0.0;
+                if constexpr (kMonitor) return 0.0;
+                else return;
+            }
+            double A = a[i];
+            double sum_diff = 0.0;
+            for(int nb : nodes[i].getNeighbors()){
+                sum_diff += (a[nb] - A);
+            }
+            return nodo(i, sum_diff);
+        });
+    };
+    const CambioPaso cambio = conBool(hasDenseSource(), [&](auto cf){
+        return conBool(monitor_convergencia, [&](auto mon){
+            return conBool(tracker != nullptr, [&](auto seg){ return kernel(cf, mon, seg); });
+        });
+    });
+
+    applyPointSources(new_amplitude, t_now);
+    if(monitor_convergencia) recordChange(cambio.max, cambio.suma2, new_amplitude);
+    if(tracker) trackPointSources(new_amplitude, paso);
+    commitStep();
+}
+
+/*
+metodo: setSellLayout
+descripcion: Activa o desactiva la representación SELL-C-sigma para las topologías explícitas (se construye en el
+             siguiente paso y se reconstruye tras cada cambio de topología). Conviene en redes aleatorias y de mundo
+             pequeño, donde los grados son parecidos y el relleno es poco
+retorno: -
+*/
+void Network::setSellLayout(bool enabled){
+    usar_sell = enabled;
+    sell_valida = false;
+    if(!enabled) sell.clear();
+}
+
+/*
+metodo: setArrivalTracker
+descripcion: Registra un seguimiento de llegadas que el kernel actualiza con el nuevo valor de cada nodo en cada
+             paso. La red no toma posesión del objeto
+retorno: -
+*/
+void Network::setArrivalTracker(ArrivalTracker* tracker){
+    if(tracker && tracker->getSize() != network_size){
+        throw std::runtime_error("El seguimiento de llegadas no coincide con el numero de nodos");
+    }
+    arrival_tracker = tracker;
+}
+
+/*
+metodo: trackPointSources
+descripcion: En modo Sparse el kernel no ve las fuentes puntuales: sus nodos se registran después del scatter
+retorno: -
+*/
+void Network::trackPointSources(const double* new_amplitude, int paso){
+    if(source_mode != SourceMode::Sparse) return;
+    for(const PointSource& p : point_sources) arrival_tracker->update(p.node, new_amplitude[p.node], paso);
+}
+
+/*
+metodo: setConvergenceMonitor
+descripcion: Activa o desactiva el monitor de convergencia: el cambio máximo y la norma L2 del cambio de cada
+             paso se calculan dentro del mismo recorrido del kernel (reducción de OpenMP)
+retorno: -
+*/
+void Network::setConvergenceMonitor(bool enabled){
+    monitor_convergencia = enabled;
+    ultimo_cambio_max = 0.0;
+    ultimo_cambio_l2 = 0.0;
+}
+
+/*
+metodo: pointSourceMask
+descripcion: Marca de los nodos con fuente puntual. En modo Sparse el kernel no conoce esas fuentes, así que su
+             cambio (y su llegada) se registra después del scatter. Solo se construye con el monitor o el seguimiento
+retorno: puntero a la marca por nodo
+*/
+const char* Network::pointSourceMask(){
+    if(!mascara_valida || (int)mascara_fuentes.size() != network_size){
+        mascara_fuentes.assign(network_size, 0);
+        for(const PointSource& p : point_sources) mascara_fuentes[p.node] = 1;
+        mascara_valida = true;
+    }
+    return mascara_fuentes.data();
+}
+
+/*
+metodo: recordChange
+descripcion: Guarda el cambio del paso, agregando el de los nodos con fuente puntual (medido tras el scatter)
+retorno: -
+*/
+void Network::recordChange(double max_change, double sum_sq, const double* new_amplitude){
+    if(source_mode == SourceMode::Sparse){
+        for(const PointSource& p : point_sources){
+            if(mascara_fuentes[p.node] != 1) continue;      // fuentes repetidas en el mismo nodo
+            mascara_fuentes[p.node] = 2;
+            const double d = new_amplitude[p.node] - amplitudes[p.node];
+            max_change = std::max(max_change, std::fabs(d));
+            sum_sq += d * d;
+        }
+        for(const PointSource& p : point_sources) mascara_fuentes[p.node] = 1;
+    }
+    ultimo_cambio_max = max_change;
+    ultimo_cambio_l2 = std::sqrt(sum_sq);
+}
+
+/*
+metodo: getSteadySource
+descripcion: Vector de fuentes constante (estado estacionario y avance espectral). Las fuentes que dependen del
+             tiempo (Sine, Streamed o fuentes puntuales oscilantes) no se pueden expresar así
+retorno: -
+*/
+void Network::getSteadySource(std::vector<double>& out) const {
+    out.assign(network_size, 0.0);
+    switch(source_mode){
+        case SourceMode::Zero:
+            break;
+        case SourceMode::Fixed:
+        case SourceMode::Random:
+            std::copy(sources.begin(), sources.begin() + std::min<size_t>(sources.size(), out.size()), out.begin());
+            break;
+        case SourceMode::Sparse:
+            for(const PointSource& p : point_sources){
+                if(p.amplitude != 0.0) throw std::runtime_error("Las fuentes puntuales oscilantes no son constantes");
+                out[p.node] += p.value;
+            }
+            break;
+        default:
+            throw std::runtime_error("La fuente depende del tiempo: se necesita una fuente constante");
+    }
+    for(int i = 0; i < network_size; ++i){
+        if(isRemoved(i)) out[i] = 0.0;
+    }
+}
+
+/*
+metodo: solveSteadyState
+descripcion: Calcula el equilibrio con gradiente conjugado precondicionado partiendo del estado actual, y lo
+             deja como estado de la red (amplitud actual y previa)
+retorno: iteraciones, residuo y tiempo del solver
+*/
+SteadyStateSolver::Result Network::solveSteadyState(SteadyStateSolver::Method method, double tol, int max_iter){
+    if(!pending_updates.empty()) commitTopology();
+
+    std::vector<double> rhs;
+    getSteadySource(rhs);
+
+    std::vector<double> x = amplitudes;
+    SteadyStateSolver::Result res = SteadyStateSolver::solve(*this, rhs, x, method, tol, max_iter);
+    amplitudes = x;
+    previous_amplitudes = std::move(x);
+    ++state_version;
+    return res;
+}
+
+/*
+metodo: fastForward
+descripcion: Avanza la red "steps" pasos de una vez en el espacio de la DCT (mallas abiertas con fuente constante).
+             El resultado es el mismo que integrar paso a paso, salvo redondeo, y deja también el estado previo
+retorno: -
+*/
+void Network::fastForward(long long steps){
+    if(steps <= 0) return;
+    if(time_step <= 0.0){
+        throw std::runtime_error("Los pasos no han sido configurados");
+    }
+    if(!pending_updates.empty()) commitTopology();
+
+    std::vector<double> S;
+    getSteadySource(S);
+    SpectralFastForward::advance(*this, amplitudes, S, time_step, steps, scratch_amplitudes, &previous_amplitudes);
+    amplitudes.swap(scratch_amplitudes);
+    current_time += static_cast<double>(steps) * time_step;
+    current_step += steps;
+    ++state_version;
+}
+
+/*
+metodo: beginStep
+descripcion: Prepara la fuente del paso en curso: con forzamiento por archivo toma la fila del paso
+             (la hebra auxiliar del stream ya la dejó en memoria). Pasada la última fila del archivo la fuente
+             queda en 0, y se avisa una sola vez por stderr
+retorno: -
+*/
+void Network::beginStep(){
+    if(source_mode == SourceMode::Streamed){
+        forcing_row = forcing_stream ? forcing_stream->row(current_step) : nullptr;
+        if(!forcing_row && forcing_stream && !forcing_agotado){
+            std::cerr << "Aviso: el archivo de forzamiento termina en el paso " << forcing_stream->getSteps()
+                      << "; los pasos siguientes no tienen forzamiento\n";
+            forcing_agotado = true;
+        }
+    }
+}
+
+/*
+metodo: commitStep
+descripcion: Fase de escritura: la amplitud actual pasa a ser la previa y el buffer calculado pasa a ser la actual.
+             Se intercambian los buffers en vez de copiar nodo a nodo
+retorno: -
+*/
+void Network::commitStep(){
+    previous_amplitudes.swap(amplitudes);
+    amplitudes.swap(scratch_amplitudes);
     current_time += time_step;
+    ++current_step;
+    ++state_version;
 }
 
 /*
 metodo: propagateWavesCollapse
-descripcion: Función que propaga las ondas en la red 2D utilizando la cláusula collapse
+descripcion: Función que propaga las ondas en la red 2D (o 3D) utilizando la cláusula collapse
 retorno: -
 */
 void Network::propagateWavesCollapse(){
@@ -277,48 +1103,192 @@ void Network::propagateWavesCollapse(){
         std::cerr << "Los pasos no han sido configurados\n";
         time_step = 0.01;
     }
-    if (ancho_malla <= 0 || alto_malla <= 0 || ancho_malla * alto_malla != network_size) {
-        std::cerr << "[propagateWavesCollapse] La red no fue inicializada en 2D correctamente.\n";
+    if (dimensiones < 2) {
+        std::cerr << "[propagateWavesCollapse] La red no fue inicializada en 2D o 3D correctamente.\n";
         return;
     }
 
     const int W = ancho_malla;
     const int H = alto_malla;
+    const int Dp = profundidad_malla;
+    const bool periodic = (boundary == Boundary::Periodic);
     const double D = diffusion_coeff;
     const double gamma = damping_coeff;
 
-    std::vector<double> new_amplitude(network_size, 0.0);
-    auto idx = [&](int r, int c){ return r*W + c; };
+    if((int)scratch_amplitudes.size() != network_size) scratch_amplitudes.assign(network_size, 0.0);
+    double* new_amplitude = scratch_amplitudes.data();
+    const double* a = amplitudes.data();
+    auto idx = [&](int z, int r, int c){ return (z*H + r)*W + c; };
     const double t_now = current_time;
+    const bool dense = hasDenseSource();
+    const bool monitor = monitor_convergencia;
+    ArrivalTracker* tracker = arrival_tracker;
+    const int paso = static_cast<int>(current_step + 1);
+    const char* en_fuente = ((monitor || tracker) && source_mode == SourceMode::Sparse) ? pointSourceMask() : nullptr;
+    double mx = 0.0, s2 = 0.0;
+    beginStep();
 
-    #pragma omp parallel for collapse(2) schedule(static)
-    for (int r = 0; r < H; ++r) {
-        for (int c = 0; c < W; ++c) {
-            int i = idx(r, c);
-            const Node& node = nodes[i];
-            double A = node.getAmplitude();
-            double sum_diff = 0.0;
-            for (int nb : node.getNeighbors()){
-                sum_diff += (nodes[nb].getAmplitude() - A);
+    const int hebras = ExecutionPolicy::threadsFor(network_size);
+    #pragma omp parallel for collapse(3) schedule(static) if(hebras > 1) num_threads(hebras) \
+        reduction(max:mx) reduction(+:s2)
+    for (int z = 0; z < Dp; ++z) {
+        for (int r = 0; r < H; ++r) {
+            for (int c = 0; c < W; ++c) {
+                int i = idx(z, r, c);
+                double A = a[i];
+                double sum_diff = latticeDiffSum(a, i, W, H, Dp, periodic);
+                double source_term = dense ? evalSourceTerm(i, t_now) : 0.0;
+                double delta = time_step * (D * sum_diff - gamma * A + source_term);
+                new_amplitude[i] = A + delta;
+                if(monitor && !(en_fuente && en_fuente[i])){
+                    mx = std::max(mx, std::fabs(delta));
+                    s2 += delta * delta;
+                }
+                if(tracker && !(en_fuente && en_fuente[i])) tracker->update(i, A + delta, paso);
             }
-            double source_term = evalSourceTerm(i, t_now);
-            double delta = time_step * (D * sum_diff - gamma * A + source_term);
-            new_amplitude[i] = A + delta;
         }
     }
 
-    #pragma omp parallel for schedule(static)
-    for (int i = 0; i < network_size; ++i){
-        nodes[i].setPreviousAmplitude(nodes[i].getAmplitude());
-        nodes[i].setAmplitude(new_amplitude[i]);
+    applyPointSources(new_amplitude, t_now);
+    if(monitor) recordChange(mx, s2, new_amplitude);
+    if(tracker) trackPointSources(new_amplitude, paso);
+    commitStep();
+}
+
+/*
+metodo: materializeTopology
+descripcion: Convierte una malla implícita en topología explícita (listas de vecinos por nodo), necesario
+             antes de modificar aristas. El orden de los vecinos es el mismo que usa el kernel de la malla
+retorno: -
+*/
+void Network::materializeTopology(){
+    sell_valida = false;
+    if(!isLattice()) return;
+
+    std::vector<Node> explicitos;
+    explicitos.reserve(network_size);
+    std::vector<int> vecinos;
+    for(int i = 0; i < network_size; ++i){
+        explicitos.emplace_back(i);
+        getNeighbors(i, vecinos);
+        for(int nb : vecinos) explicitos.back().addNeighbor(nb);
     }
+    nodes.swap(explicitos);
+    dimensiones = 0;
+}
 
-    current_time += time_step;
+/*
+metodo: addEdge
+descripcion: Encola una arista no dirigida a-b (se ignora si ya existe al aplicar el lote)
+retorno: -
+*/
+void Network::addEdge(int a, int b){
+    if(a == b || a < 0 || b < 0 || a >= network_size || b >= network_size) return;
+    pending_updates.push_back(TopologyUpdate{a, b, true});
 }
 
 /*
-metodo: getNode
-descripcion: Función que obtiene los nodos
+metodo: removeEdge
+descripcion: Encola la eliminación de la arista a-b
+retorno: -
+*/
+void Network::removeEdge(int a, int b){
+    if(a == b || a < 0 || b < 0 || a >= network_size || b >= network_size) return;
+    pending_updates.push_back(TopologyUpdate{a, b, false});
+}
+
+/*
+metodo: addNode
+descripcion: Agrega un nodo aislado al final de la red (sus aristas se agregan con addEdge).
+             Se debe llamar entre pasos. Si hay un seguimiento de llegadas también crece; con forzamiento
+             desde archivo el nodo nuevo no tiene columna y su fuente es 0
+retorno: entero con el id del nuevo nodo
+*/
+int Network::addNode(double amplitude){
+    materializeTopology();
+    const int id = network_size++;
+    nodes.emplace_back(id);
+    amplitudes.push_back(amplitude);
+    previous_amplitudes.push_back(amplitude);
+    scratch_amplitudes.push_back(0.0);
+    ++state_version;
+    sources.push_back(0.0);
+    if(!removed_nodes.empty()) removed_nodes.push_back(0);
+    if(arrival_tracker) arrival_tracker->addNode();
+    return id;
+}
+
+/*
+metodo: removeNode
+descripcion: Elimina un nodo sin renumerar la red: se encola la eliminación de todas sus aristas, su amplitud
+             queda en cero y el kernel deja de actualizarlo
+retorno: -
+*/
+void Network::removeNode(int i){
+    if(i < 0 || i >= network_size) return;
+    materializeTopology();
+    for(int nb : nodes[i].getNeighbors()) removeEdge(i, nb);
+    if(removed_nodes.empty()) removed_nodes.assign(network_size, 0);
+    removed_nodes[i] = 1;
+    amplitudes[i] = 0.0;
+    previous_amplitudes[i] = 0.0;
+    ++state_version;
+}
+
+/*
+metodo: commitTopology
+descripcion: Aplica en lote las actualizaciones encoladas. Cada arista genera dos medias aristas (a->b y b->a),
+             se ordenan por nodo (conservando el orden de llegada) y cada grupo se aplica en paralelo: como
+             cada nodo pertenece a un solo grupo, no hay carreras sobre las listas de vecinos
 retorno: -
 */
-Node& Network::getNode(int i){ return this->nodes[i]; }
\ No newline at end of file
+void Network::commitTopology(){
+    if(pending_updates.empty()) return;
+    materializeTopology();
+
+    std::vector<TopologyUpdate> medias;
+    medias.reserve(2 * pending_updates.size());
+    for(const TopologyUpdate& u : pending_updates){
+        medias.push_back(TopologyUpdate{u.a, u.b, u.add});
+        medias.push_back(TopologyUpdate{u.b, u.a, u.add});
+    }
+    pending_updates.clear();
+    sell_valida = false;
+    std::stable_sort(medias.begin(), medias.end(),
+                     [](const TopologyUpdate& x, const TopologyUpdate& y){ return x.a < y.a; });
+
+    std::vector<int> grupos;
+    for(size_t k = 0; k < medias.size(); ++k){
+        if(k == 0 || medias[k].a != medias[k-1].a) grupos.push_back(static_cast<int>(k));
+    }
+    grupos.push_back(static_cast<int>(medias.size()));
+
+    const int G = static_cast<int>(grupos.size()) - 1;
+    #pragma omp parallel for schedule(dynamic, 64) if(G > 256)
+    for(int g = 0; g < G; ++g){
+        Node& node = nodes[medias[grupos[g]].a];
+        for(int k = grupos[g]; k < grupos[g + 1]; ++k){
+            const TopologyUpdate& u = medias[k];
+            if(u.add){
+                if(!isRemoved(u.b) && !isRemoved(u.a) && !node.isNeighbor(u.b)) node.addNeighbor(u.b);
+            } else {
+                node.removeNeighbor(u.b);
+            }
+        }
+    }
+}
+
+/*
+metodo: getNode
+descripcion: Función que obtiene los nodos de una red con topología explícita. Las mallas no guardan nodos y
+             convertirlas costaría una lista de vecinos por nodo (lo que la malla implícita ahorra), así que en una
+             malla se lanza una excepción: para leer se usan getNeighbors y getDegree, y la conversión la hace la
+             primera modificación (addEdge, removeEdge, removeNode, addNode)
+retorno: referencia al nodo
+*/
+Node& Network::getNode(int i){
+    if(isLattice()){
+        throw std::runtime_error("getNode no aplica a una malla implicita: use getNeighbors o getDegree");
+    }
+    return this->nodes.at(i);
+}
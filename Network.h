@@ -2,12 +2,21 @@
 #define NETWORK_H
 
 #include "Node.h"
+#include "SteadyStateSolver.h"
+#include "StateView.h"
+#include "SellCSigma.h"
+#include <cstdint>
 #include <vector>
 #include <string>
 
+class ForcingStream;
+class ArrivalTracker;
+
 /*
 Abstracción:
-Clase network  encaargada de la creacion de la estructura que poseerá la malla de propagación de energia
+Clase network  encaargada de la creacion de la estructura que poseerá la malla de propagación de energia.
+Las amplitudes se guardan en arreglos contiguos. Las mallas regulares (1D, 2D y 3D) no guardan listas de
+vecinos: los vecinos se calculan a partir de las coordenadas, así la memoria por nodo es solo el estado
 */
 
 class Network {
@@ -17,7 +26,31 @@ public:
         Zero = 0,
         Fixed = 1,
         Random = 2,
-        Sine_uniform = 3
+        Sine_uniform = 3,
+        Streamed = 4,       // S_i(t) leído por paso desde un archivo mapeado (ForcingStream)
+        Sparse = 5          // pocas fuentes puntuales, se aplican después del kernel
+    };
+
+    //Condición de borde de las mallas regulares
+    enum class Boundary{
+        Open = 0,       // los nodos del borde tienen menos vecinos
+        Periodic = 1    // toro: el borde se conecta con el borde opuesto
+    };
+
+    //Memoria usada por la red, en bytes (capacidad reservada de cada arreglo)
+    struct MemoryFootprint{
+        size_t topology = 0;        // nodos y listas de vecinos
+        size_t allocator = 0;       // estimación del sobrecosto del asignador por cada lista de vecinos
+        size_t state = 0;           // amplitud actual y previa
+        size_t sources = 0;         // fuentes densas, puntuales y máscaras
+        size_t scratch = 0;         // buffer del siguiente paso
+        size_t other = 0;           // cambios de topología pendientes y nodos eliminados
+        long long nodes = 0;
+        long long edges = 0;
+
+        size_t total() const { return topology + allocator + state + sources + scratch + other; }
+        double bytesPerNode() const { return nodes > 0 ? double(total()) / nodes : 0.0; }
+        double bytesPerEdge() const { return edges > 0 ? double(total()) / edges : 0.0; }
     };
 
     //Constructor
@@ -25,7 +58,8 @@ public:
     
     //Funciones solicitdas en el enunciado
     void initializeRandomNetwork();
-    void initializeRegularNetwork(int dimensions, int w = 0, int h = 0);
+    void initializeRegularNetwork(int dimensions, int w = 0, int h = 0, int d = 1,
+                                  Boundary boundary = Boundary::Open);
 
     //GETTERS
     int getSize() const { return network_size; }
@@ -35,32 +69,68 @@ public:
     const std::vector<Node>& getNodes() const {return nodes; }
     bool isInitialized() const {return initialized;}
 
+    int getDimensions() const {return dimensiones;}
     int getAltoMalla() const {return alto_malla;}
     int getAnchoMalla() const {return ancho_malla;}
-    Node& getNode(int index);
-    std::vector<double> getCurrentAmplitudes() const {
-        std::vector<double> out;
-        out.reserve(nodes.size());
-        for(auto& n : nodes) out.push_back(n.getAmplitude());
-        return out;
-    };
+    int getProfundidadMalla() const {return profundidad_malla;}
+    Boundary getBoundary() const {return boundary;}
+    bool isLattice() const {return dimensiones > 0;}
+    int getDegree(int i) const;
+    long long getEdgeCount() const;
+    MemoryFootprint getMemoryFootprint() const;
+    static size_t peakRssBytes();
+    void getNeighbors(int i, std::vector<int>& out) const;
+
+    Node& getNode(int index);          // solo topología explícita; en una malla lanza (ver getNeighbors)
+    double getAmplitude(int i) const {return amplitudes[i];}
+    double getPreviousAmplitude(int i) const {return previous_amplitudes[i];}
+    std::vector<double>& getAmplitudes() {return amplitudes;}
+    const std::vector<double>& getAmplitudes() const {return amplitudes;}
+    std::vector<double> getCurrentAmplitudes() const { return amplitudes; }
+    StateView getStateView() const { return StateView(amplitudes.data(), amplitudes.size(), current_step, state_version); }
+    uint64_t getStateVersion() const {return state_version;}
 
     double getCurrentTime() const {return current_time;}
+    long long getCurrentStep() const {return current_step;}
+    double getLastMaxChange() const {return ultimo_cambio_max;}
+    double getLastL2Change() const {return ultimo_cambio_l2;}
     SourceMode getSourceMode() const {return source_mode;}
 
     //SETTERS
+    void setAmplitude(int i, double value) {amplitudes[i] = value; ++state_version;}
     void setTimeStep(double dt) {time_step = dt;}
     void setSources(const std::vector<double>& src);
     void setZeroSource();
     void generateRandomSources(double min_value, double max_value, unsigned int seed = 5489u);
     void setSineSource(double amplitude, double omega); // S(t)=A sin(ωt)
+    void setStreamedSource(ForcingStream* stream);
     void setSourceMode(SourceMode mode) { source_mode = mode; }
+    void addPointSource(int node, double value, double amplitude = 0.0, double omega = 0.0);
+    void clearPointSources();
+    size_t getPointSourceCount() const { return point_sources.size(); }
+    void setDiffusionCoeff(double D) { diffusion_coeff = D; }
+    void setDampingCoeff(double gamma) { damping_coeff = gamma; }
+    void resetState();
+    void setConvergenceMonitor(bool enabled);
+    void setArrivalTracker(ArrivalTracker* tracker);
+    void setSellLayout(bool enabled);
+    bool usesSellLayout() const {return usar_sell;}
+    const SellCSigma& getSellLayout() const {return sell;}
+
+    //Estado estacionario resolviendo (D*L + gamma*I) A = S directamente, sin integrar en el tiempo
+    SteadyStateSolver::Result solveSteadyState(SteadyStateSolver::Method method = SteadyStateSolver::Method::IC0,
+                                               double tol = 1e-10, int max_iter = 10000);
+    void getSteadySource(std::vector<double>& out) const;
+
+    //Avance espectral exacto de muchos pasos (mallas abiertas con fuente constante), O(N log N)
+    void fastForward(long long steps);
 
     //otros metodos
     void initializeLinearNetwork();
     void initializeGrid2D(int width, int height);
-    void initializeRandomNetwork(double connection_probability);
-    void initializeSmallWorldNetwork(int k, double beta);
+    void initializeRandomNetwork(double connection_probability, unsigned int seed = 5489u);
+    void initializeSmallWorldNetwork(int k, double beta, unsigned int seed = 5489u);
+    void initializeScaleFreeNetwork(int m, unsigned int seed = 5489u);
     void verifyGridConnections() const;
     void debugRandomNetwork() const;
 
@@ -70,33 +140,95 @@ public:
     void propagateWaves(int schedule_type, int chunk_size);
     void propagateWavesCollapse();
 
+    //Mutación de la topología entre pasos. Las aristas se encolan y se aplican en lote (en paralelo por nodo)
+    //al llamar commitTopology o al inicio del siguiente paso. Las mallas se convierten a topología explícita
+    void addEdge(int a, int b);
+    void removeEdge(int a, int b);
+    int addNode(double amplitude = 0.0);
+    void removeNode(int i);
+    void commitTopology();
+    size_t pendingTopologyUpdates() const { return pending_updates.size(); }
+    bool isRemoved(int i) const { return !removed_nodes.empty() && removed_nodes[i]; }
+
 private:
+    //Fuente puntual: S(t) = value + amplitude sin(omega t) en un nodo
+    struct PointSource{
+        int node;
+        double value;
+        double amplitude;
+        double omega;
+    };
+
+    //Actualización de topología pendiente (arista a-b)
+    struct TopologyUpdate{
+        int a;
+        int b;
+        bool add;
+    };
+
     //datos privados
-    std::vector<Node> nodes;
+    std::vector<Node> nodes;    // solo para topologías explícitas (vacío en mallas regulares)
+    SellCSigma sell;            // copia SELL-C-sigma de la topología explícita (solo si usar_sell)
+    bool usar_sell = false;
+    bool sell_valida = false;
     int network_size;
     double diffusion_coeff;
     double damping_coeff;
 
-    //En caso de que sea una network 2D
+    //Malla regular implícita (dimensiones = 0 si la topología es explícita)
+    int dimensiones = 0;
     int ancho_malla = 0;
     int alto_malla = 0;
+    int profundidad_malla = 0;
+    Boundary boundary = Boundary::Open;
 
     bool initialized = false;
 
+    //Estado: amplitud actual, amplitud previa y buffer para el siguiente paso
+    std::vector<double> amplitudes;
+    std::vector<double> previous_amplitudes;
+    std::vector<double> scratch_amplitudes;
+
     std::vector<double> sources;
     double time_step = 0.0;
     double current_time = 0.0;
+    long long current_step = 0;
+    uint64_t state_version = 0;                 // cambia con cada modificación del estado hecha por la red
+
+    //Monitor de convergencia: cambio máximo y norma L2 del cambio del último paso
+    bool monitor_convergencia = false;
+    double ultimo_cambio_max = 0.0;
+    double ultimo_cambio_l2 = 0.0;
+    ArrivalTracker* arrival_tracker = nullptr;  // seguimiento de llegadas (no es dueño)
+    std::vector<char> mascara_fuentes;         // nodos con fuente puntual (monitor o llegadas en modo Sparse)
+    bool mascara_valida = false;
+
+    //Actualizaciones de topología pendientes y nodos eliminados (vacío si nunca se eliminó uno)
+    std::vector<TopologyUpdate> pending_updates;
+    std::vector<char> removed_nodes;
 
     //Configuración de fuente
     SourceMode source_mode = SourceMode::Fixed;
     double source_amplitude = 0.0;
     double source_omega = 0.0;
-
-    std::vector<double> scratch_amplitudes;
+    std::vector<PointSource> point_sources;
+    ForcingStream* forcing_stream = nullptr;    // no es dueño del stream
+    const double* forcing_row = nullptr;        // fila del paso en curso (nullptr: sin forzamiento)
+    int forcing_nodes = 0;                      // columnas del stream; los nodos agregados después tienen fuente 0
+    bool forcing_agotado = false;               // ya se avisó que el archivo no tiene más filas
 
     //otros metodos privados
     void propagateCore(int schedule_type, int chunk_size, bool use_chunk);
+    void beginStep();
+    void commitStep();
+    void materializeTopology();
+    void resetExplicitTopology();
     inline double evalSourceTerm(int i, double t) const;
+    bool hasDenseSource() const { return source_mode != SourceMode::Zero && source_mode != SourceMode::Sparse; }
+    void applyPointSources(double* new_amplitude, double t) const;
+    const char* pointSourceMask();
+    void trackPointSources(const double* new_amplitude, int paso);
+    void recordChange(double max_change, double sum_sq, const double* new_amplitude);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -6,11 +6,11 @@
 
 /*
 metodo: node
-descripcion: constructor del elemento nodo, el cual posee su id, amplitud actual y amplitud previa
+descripcion: constructor del elemento nodo, el cual posee su id y su lista de vecinos
 retorno: un nodo
 */
-Node::Node(int node_id, double initial_amplitude) 
-    : id(node_id), amplitude(initial_amplitude), previous_amplitude(initial_amplitude) {}
+Node::Node(int node_id) 
+    : id(node_id) {}
 
 /*
 metodo: getId
@@ -19,21 +19,6 @@ retorno: entero id del nodo
 */
 int Node::getId() const { return id; }
 
-/*
-metodo: getAmplitude
-descripcion: obtiene la amplitud actual de un nodo
-retorno: -
-*/
-double Node::getAmplitude() const { return amplitude; }
-
-/*
-metodo: getPreviousAmplitude
-descripcion: Obtiene la amplitud previa del nodo
-retorno: double amplitud que posee un nodo
-*/
-double Node::getPreviousAmplitude() const { return previous_amplitude; }
-
-
 /*
 metodo: getNeighbors
 descripcion: obtiene todos los nodos vecinos
@@ -49,20 +34,6 @@ retorno: entero grado de un nodo
 int Node::getDegree() const { return neighbors.size(); }
 
 
-/*
-metodo: setAmplitude
-descripcion: coloca la nueva amplitud
-retorno: -
-*/
-void Node::setAmplitude(double new_amplitude) { amplitude = new_amplitude; }
-
-/*
-metodo: setPreviousAmplitude
-descripcion: Coloca la amplitud previa
-retorno: -
-*/
-void Node::setPreviousAmplitude(double prev_amp) { previous_amplitude = prev_amp; }
-
 /*
 metodo: addNeighbor
 descripcion: Agregar nodos vecinos a un nodo especifico
@@ -74,6 +45,16 @@ void Node::addNeighbor(int neighbor_id) {
 }
 
 
+/*
+metodo: removeNeighbor
+descripcion: Elimina un vecino de la lista del nodo (si existe), conservando el orden de los demás
+retorno: -
+*/
+void Node::removeNeighbor(int neighbor_id) {
+    auto it = std::find(neighbors.begin(), neighbors.end(), neighbor_id);
+    if (it != neighbors.end()) neighbors.erase(it);
+}
+
 /*
 metodo: isNeighbor
 descripcion: encargado de verificar si un par de nodos son vecinos
@@ -2,7 +2,8 @@
 
 /*
 Abstracción:
-Esta clase corresponde a la unidad nodo, necesario para representar la red  y propagagar a través de ellos la energía 
+Esta clase corresponde a la unidad nodo, necesario para representar la red  y propagagar a través de ellos la energía.
+El nodo solo guarda la topología (id y vecinos); las amplitudes viven en arreglos contiguos dentro de Network
 */
 
 
@@ -10,21 +11,14 @@ class Node {
     public:
 
         //Constructor
-        Node(int node_id, double initial_amplitude = 0.0);
+        Node(int node_id);
 
         //Getters
         int getId() const;
-        double getAmplitude() const;
-        double getPreviousAmplitude() const;
         const std::vector<int>& getNeighbors() const;
         int getDegree() const;
 
 
-        //Setter
-        void setAmplitude(double new_amplitude);
-        void setPreviousAmplitude(double prev_amp);
-
-
         //otros metodos
         void addNeighbor(int neighbor_id);//Con esto agregamos los nodos
 
@@ -36,8 +30,6 @@ class Node {
     
         //datos privados 
         int id;       //un id para identificar al nodo                  
-        double amplitude; //La amplitud que este va a tener
-        double previous_amplitude; //La amplitud anterior que este va a tener
         std::vector<int> neighbors; //Los vecinos del nodos
         
     };
@@ -0,0 +1,344 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <omp.h>
+
+#include "OutOfCore.h"
+#include "Network.h"
+
+/*
+metodo: MappedFile
+descripcion: Constructor, mapea un archivo en memoria. Si writable es true el archivo se crea (o trunca)
+             con el tamaño pedido; si no, se mapea completo en solo lectura
+retorno: -
+*/
+MappedFile::MappedFile(const std::string& path, bool writable, size_t size){
+    fd = writable ? open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) : open(path.c_str(), O_RDONLY);
+    if(fd < 0) throw std::runtime_error("No se pudo abrir " + path);
+
+    if(writable){
+        if(ftruncate(fd, static_cast<off_t>(size)) != 0){
+            close(fd);
+            throw std::runtime_error("No se pudo reservar " + path);
+        }
+        length = size;
+    } else {
+        struct stat st;
+        if(fstat(fd, &st) != 0){
+            close(fd);
+            throw std::runtime_error("No se pudo leer el tamaño de " + path);
+        }
+        length = static_cast<size_t>(st.st_size);
+    }
+
+    void* p = mmap(nullptr, length, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    if(p == MAP_FAILED){
+        close(fd);
+        throw std::runtime_error("No se pudo mapear " + path);
+    }
+    base = static_cast<char*>(p);
+}
+
+/*
+metodo: ~MappedFile
+descripcion: Destructor, libera el mapeo y cierra el archivo
+retorno: -
+*/
+MappedFile::~MappedFile(){
+    if(base) munmap(base, length);
+    if(fd >= 0) close(fd);
+}
+
+/*
+metodo: advise
+descripcion: madvise sobre un rango del archivo (el rango se alinea a páginas)
+retorno: -
+*/
+void MappedFile::advise(size_t offset, size_t bytes, int advice) const {
+    if(!base || bytes == 0) return;
+    const size_t pagina = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t inicio = (offset / pagina) * pagina;
+    const size_t fin = std::min(length, offset + bytes);
+    madvise(base + inicio, fin - inicio, advice);
+}
+
+/*
+metodo: touch
+descripcion: Lee un byte por página del rango para forzar que las páginas se carguen desde el disco
+retorno: -
+*/
+void MappedFile::touch(size_t offset, size_t bytes) const {
+    const size_t pagina = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t fin = std::min(length, offset + bytes);
+    volatile char sink = 0;
+    for(size_t p = offset; p < fin; p += pagina) sink += base[p];
+    (void)sink;
+}
+
+/*
+metodo: OutOfCoreNetwork
+descripcion: Constructor, mapea la topología, crea los dos archivos de estado junto a ella y divide los nodos
+             en particiones de aproximadamente kBytesPorParticion de adyacencia. Antes valida la cabecera, los
+             offsets y cada vecino (una pasada secuencial por el archivo)
+retorno: -
+*/
+OutOfCoreNetwork::OutOfCoreNetwork(const std::string& topology_path, double diff_coeff, double damp_coeff)
+    : topologia(topology_path, false),
+      diffusion_coeff(diff_coeff),
+      damping_coeff(damp_coeff)
+{
+    const uint64_t* cabecera = reinterpret_cast<const uint64_t*>(topologia.data());
+    if(topologia.size() < 3 * sizeof(uint64_t) || cabecera[0] != kMagic){
+        throw std::runtime_error("Archivo de topologia invalido: " + topology_path);
+    }
+    num_nodes = cabecera[1];
+    num_edges = cabecera[2];
+
+    //La cabecera no es confiable: se comprueba que offsets (N + 1) y adyacencia (E) quepan en el archivo sin
+    //calcular el tamaño total, que podría desbordarse con valores corruptos
+    const uint64_t resto = topologia.size() - 3 * sizeof(uint64_t);
+    if(num_nodes >= resto / sizeof(uint64_t) ||
+       num_edges > (resto - (num_nodes + 1) * sizeof(uint64_t)) / sizeof(uint32_t)){
+        throw std::runtime_error("Archivo de topologia truncado: " + topology_path);
+    }
+    offsets = cabecera + 3;
+    adyacencia = reinterpret_cast<const uint32_t*>(offsets + num_nodes + 1);
+    if(offsets[0] != 0 || offsets[num_nodes] != num_edges){
+        throw std::runtime_error("Offsets inconsistentes en " + topology_path);
+    }
+
+    //Particiones por cantidad de aristas (cada una con al menos un nodo)
+    const uint64_t aristas_por_particion = std::max<uint64_t>(1, kBytesPorParticion / sizeof(uint32_t));
+    particiones.push_back(0);
+    uint64_t inicio_aristas = 0;
+    for(uint64_t i = 1; i <= num_nodes; ++i){
+        if(offsets[i] < offsets[i - 1] || offsets[i] > num_edges){
+            throw std::runtime_error("Offsets no crecientes en " + topology_path);
+        }
+        //El kernel lee a[adyacencia[j]]: un vecino fuera de la red leería fuera del estado
+        for(uint64_t j = offsets[i - 1]; j < offsets[i]; ++j){
+            if(adyacencia[j] >= num_nodes) throw std::runtime_error("Vecino fuera de la red en " + topology_path);
+        }
+        if(offsets[i] - inicio_aristas >= aristas_por_particion || i == num_nodes){
+            particiones.push_back(i);
+            inicio_aristas = offsets[i];
+        }
+    }
+
+    estado[0] = std::make_unique<MappedFile>(topology_path + ".state0", true, num_nodes * sizeof(double));
+    estado[1] = std::make_unique<MappedFile>(topology_path + ".state1", true, num_nodes * sizeof(double));
+
+    //La lectura de la adyacencia es secuencial dentro de cada partición
+    topologia.advise(0, topologia.size(), MADV_SEQUENTIAL);
+
+    prefetcher = std::thread(&OutOfCoreNetwork::prefetchLoop, this);
+}
+
+/*
+metodo: ~OutOfCoreNetwork
+descripcion: Destructor, detiene la hebra de precarga
+retorno: -
+*/
+OutOfCoreNetwork::~OutOfCoreNetwork(){
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        terminar = true;
+    }
+    cv.notify_all();
+    if(prefetcher.joinable()) prefetcher.join();
+}
+
+/*
+metodo: prefetchPartition
+descripcion: Precarga los offsets, la adyacencia y el estado de la partición k
+retorno: -
+*/
+void OutOfCoreNetwork::prefetchPartition(int k) const {
+    const uint64_t b = particiones[k], e = particiones[k + 1];
+    const char* base = topologia.data();
+    const size_t off_ini = reinterpret_cast<const char*>(offsets + b) - base;
+    const size_t off_len = (e - b + 1) * sizeof(uint64_t);
+    const size_t ady_ini = reinterpret_cast<const char*>(adyacencia + offsets[b]) - base;
+    const size_t ady_len = (offsets[e] - offsets[b]) * sizeof(uint32_t);
+
+    topologia.advise(off_ini, off_len, MADV_WILLNEED);
+    topologia.advise(ady_ini, ady_len, MADV_WILLNEED);
+    topologia.touch(off_ini, off_len);
+    topologia.touch(ady_ini, ady_len);
+    estado[actual]->touch(b * sizeof(double), (e - b) * sizeof(double));
+}
+
+/*
+metodo: releasePartition
+descripcion: Indica al sistema que la adyacencia de la partición k ya no se necesita en este paso
+retorno: -
+*/
+void OutOfCoreNetwork::releasePartition(int k) const {
+    const uint64_t b = particiones[k], e = particiones[k + 1];
+    const char* base = topologia.data();
+    const size_t ady_ini = reinterpret_cast<const char*>(adyacencia + offsets[b]) - base;
+    topologia.advise(ady_ini, (offsets[e] - offsets[b]) * sizeof(uint32_t), MADV_DONTNEED);
+}
+
+/*
+metodo: prefetchLoop
+descripcion: Loop de la hebra auxiliar: espera pedidos de partición y las precarga
+retorno: -
+*/
+void OutOfCoreNetwork::prefetchLoop(){
+    std::unique_lock<std::mutex> lock(mtx);
+    while(true){
+        cv.wait(lock, [&]{ return terminar || pedido != listo; });
+        if(terminar) return;
+        const int k = pedido;
+        lock.unlock();
+        prefetchPartition(k);
+        lock.lock();
+        listo = k;
+        cv.notify_all();
+    }
+}
+
+/*
+metodo: requestPrefetch
+descripcion: Pide a la hebra auxiliar que precargue la partición k
+retorno: -
+*/
+void OutOfCoreNetwork::requestPrefetch(int k){
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        pedido = k;
+    }
+    cv.notify_all();
+}
+
+/*
+metodo: waitPrefetch
+descripcion: Espera a que la partición k esté precargada
+retorno: -
+*/
+void OutOfCoreNetwork::waitPrefetch(int k){
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [&]{ return listo == k; });
+}
+
+/*
+metodo: propagateWaves
+descripcion: Un paso de la simulación recorriendo las particiones en orden. Mientras se calcula la partición k
+             en paralelo, la hebra auxiliar precarga la k+1. La energía se acumula dentro del mismo recorrido
+retorno: double con la energía del nuevo estado
+*/
+double OutOfCoreNetwork::propagateWaves(){
+    const double D = diffusion_coeff;
+    const double gamma = damping_coeff;
+    const double dt = time_step;
+    const double S = source_value;
+    const double* a = current();
+    double* nuevo = next();
+    double energia = 0.0;
+
+    const int P = getPartitions();
+    requestPrefetch(0);
+    for(int k = 0; k < P; ++k){
+        waitPrefetch(k);
+        if(k + 1 < P) requestPrefetch(k + 1);
+
+        const long long b = static_cast<long long>(particiones[k]);
+        const long long e = static_cast<long long>(particiones[k + 1]);
+
+        #pragma omp parallel for schedule(dynamic, 4096) reduction(+:energia)
+        for(long long i = b; i < e; ++i){
+            const double A = a[i];
+            double sum_diff = 0.0;
+            for(uint64_t j = offsets[i]; j < offsets[i + 1]; ++j){
+                sum_diff += (a[adyacencia[j]] - A);
+            }
+            const double v = A + dt * (D * sum_diff - gamma * A + S);
+            nuevo[i] = v;
+            energia += v * v;
+        }
+
+        releasePartition(k);
+    }
+
+    actual = 1 - actual;
+    return energia;
+}
+
+/*
+metodo: writeTopology
+descripcion: Escribe la topología de una red (malla o explícita) en el formato CSR binario de OutOfCoreNetwork.
+             Los offsets se escriben con una pasada por grado y la adyacencia con otra pasada, sin armar el CSR en RAM
+retorno: -
+*/
+void OutOfCoreNetwork::writeTopology(const Network& net, const std::string& path){
+    std::ofstream f(path, std::ios::binary);
+    if(!f.is_open()) throw std::runtime_error("No se pudo crear " + path);
+
+    const uint64_t N = static_cast<uint64_t>(net.getSize());
+    uint64_t E = 0;
+    for(uint64_t i = 0; i < N; ++i) E += static_cast<uint64_t>(net.getDegree(static_cast<int>(i)));
+
+    const uint64_t cabecera[3] = {kMagic, N, E};
+    f.write(reinterpret_cast<const char*>(cabecera), sizeof(cabecera));
+
+    uint64_t acumulado = 0;
+    f.write(reinterpret_cast<const char*>(&acumulado), sizeof(acumulado));
+    for(uint64_t i = 0; i < N; ++i){
+        acumulado += static_cast<uint64_t>(net.getDegree(static_cast<int>(i)));
+        f.write(reinterpret_cast<const char*>(&acumulado), sizeof(acumulado));
+    }
+
+    std::vector<int> vecinos;
+    std::vector<uint32_t> fila;
+    for(uint64_t i = 0; i < N; ++i){
+        net.getNeighbors(static_cast<int>(i), vecinos);
+        fila.assign(vecinos.begin(), vecinos.end());
+        f.write(reinterpret_cast<const char*>(fila.data()), fila.size() * sizeof(uint32_t));
+    }
+}
+
+/*
+metodo: runOutOfCore
+descripcion: Simula steps pasos sobre una topología en disco con un pulso inicial en el nodo central y fuente
+             uniforme. Escribe la energía por paso en "datos/outofcore energy.dat"
+retorno: entero que indica si funciona correctamente
+*/
+int OutOfCoreNetwork::runOutOfCore(const std::string& topology_path, double D, double gamma, double dt,
+                                   int steps, double source_value){
+    try {
+        OutOfCoreNetwork net(topology_path, D, gamma);
+        net.setTimeStep(dt);
+        net.setUniformSource(source_value);
+        net.setAmplitude(net.getSize() / 2, 1.0);
+
+        std::cout << "Out-of-core: " << net.getSize() << " nodos, " << net.getEdges() << " aristas, "
+                  << net.getPartitions() << " particiones\n";
+
+        std::filesystem::create_directories("datos");
+        std::ofstream energy_dat("datos/outofcore energy.dat");
+        energy_dat << "# Time_Step energy\n";
+
+        double t0 = omp_get_wtime();
+        for(int step = 1; step <= steps; ++step){
+            double e = net.propagateWaves();
+            energy_dat << step << " " << std::scientific << std::setprecision(6) << e << "\n";
+        }
+        double duracion = omp_get_wtime() - t0;
+
+        std::cout << "Tiempo total: " << duracion << "s ("
+                  << (static_cast<double>(net.getEdges()) * steps / duracion) / 1e6 << " M aristas/s)\n";
+    } catch(const std::exception& e){
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
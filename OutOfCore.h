@@ -0,0 +1,108 @@
+#ifndef OUTOFCORE_H
+#define OUTOFCORE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Network;
+
+/*
+Abstracción:
+Propagación fuera de memoria (out-of-core). La topología vive en un archivo CSR mapeado en memoria y el estado
+(amplitud actual y siguiente) en dos archivos mapeados. Cada paso recorre la red por particiones de nodos;
+mientras se calcula una partición, una hebra auxiliar precarga la siguiente desde el disco
+*/
+
+//Archivo mapeado en memoria (solo lectura o lectura/escritura)
+class MappedFile{
+public:
+    //Constructores
+    MappedFile() = default;
+    MappedFile(const std::string& path, bool writable, size_t size = 0);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //getters
+    char* data() const { return base; }
+    size_t size() const { return length; }
+
+    //otros metodos
+    void advise(size_t offset, size_t bytes, int advice) const;
+    void touch(size_t offset, size_t bytes) const;
+
+private:
+    //datos privados
+    int fd = -1;
+    char* base = nullptr;
+    size_t length = 0;
+};
+
+class OutOfCoreNetwork{
+public:
+    //Formato del archivo de topología: cabecera, offsets (N+1 x uint64) y adyacencia (E x uint32)
+    static constexpr uint64_t kMagic = 0x3152534345564157ULL;   // "WAVECSR1"
+    static constexpr size_t kBytesPorParticion = 64u << 20;     // adyacencia por partición (64 MiB)
+
+    //Constructor
+    OutOfCoreNetwork(const std::string& topology_path, double diff_coeff, double damp_coeff);
+    ~OutOfCoreNetwork();
+
+    //getters
+    uint64_t getSize() const { return num_nodes; }
+    uint64_t getEdges() const { return num_edges; }
+    int getPartitions() const { return static_cast<int>(particiones.size()) - 1; }
+    double getAmplitude(uint64_t i) const { return current()[i]; }
+
+    //setters
+    void setTimeStep(double dt) { time_step = dt; }
+    void setUniformSource(double value) { source_value = value; }
+    void setAmplitude(uint64_t i, double value) { current()[i] = value; }
+
+    //otros metodos
+    double propagateWaves();
+    static void writeTopology(const Network& net, const std::string& path);
+    static int runOutOfCore(const std::string& topology_path, double D, double gamma, double dt,
+                            int steps, double source_value);
+
+private:
+    //datos privados
+    MappedFile topologia;
+    std::unique_ptr<MappedFile> estado[2];
+    int actual = 0;
+
+    uint64_t num_nodes = 0;
+    uint64_t num_edges = 0;
+    const uint64_t* offsets = nullptr;
+    const uint32_t* adyacencia = nullptr;
+    std::vector<uint64_t> particiones;   // límites de nodos de cada partición
+
+    double diffusion_coeff;
+    double damping_coeff;
+    double time_step = 0.01;
+    double source_value = 0.0;
+
+    //Hebra de precarga de la siguiente partición
+    std::thread prefetcher;
+    std::mutex mtx;
+    std::condition_variable cv;
+    int pedido = -1;       // partición pedida a la hebra
+    int listo = -1;        // última partición precargada
+    bool terminar = false;
+
+    //otros metodos privados
+    double* current() const { return reinterpret_cast<double*>(estado[actual]->data()); }
+    double* next() const { return reinterpret_cast<double*>(estado[1 - actual]->data()); }
+    void prefetchLoop();
+    void requestPrefetch(int k);
+    void waitPrefetch(int k);
+    void prefetchPartition(int k) const;
+    void releasePartition(int k) const;
+};
+
+#endif
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <omp.h>
+
+#include "ParameterSweep.h"
+#include "SimulationServer.h"
+#include "MetricsCalculator.h"
+#include "FileManagement.h"
+#include "ExecutionPolicy.h"
+#include "Telemetry.h"
+
+/*
+metodo: nodosDe
+descripcion: Tamaño de la red de un punto, calculado desde sus claves sin construirla
+retorno: numero de nodos
+*/
+static int nodosDe(const SimulationJob& job){
+    const int dims = job.getInt("dims", 1);
+    if(dims == 3) return job.getInt("w", 0) * job.getInt("h", 0) * job.getInt("d", 1);
+    if(dims == 2) return job.getInt("w", 0) * job.getInt("h", 0);
+    return job.getInt("n", 100);
+}
+
+/*
+metodo: threadsFor
+descripcion: Hebras que justifica una red de "nodos" nodos: una por cada kNodosPorHebra, entre 1 y hebras_totales
+retorno: numero de hebras
+*/
+int ParameterSweep::threadsFor(int nodos, int hebras_totales){
+    return std::max(1, std::min(hebras_totales, nodos / kNodosPorHebra));
+}
+
+/*
+metodo: readPoints
+descripcion: Lee los puntos del barrido, una linea por punto. Se ignoran las lineas vacías y las que empiezan con #
+retorno: lista de lineas
+*/
+std::vector<std::string> ParameterSweep::readPoints(const std::string& path){
+    std::ifstream in(path);
+    std::vector<std::string> puntos;
+    if(!in.is_open()){
+        std::cerr << "No se pudo abrir el archivo de barrido " << path << "\n";
+        return puntos;
+    }
+    std::string linea;
+    while(std::getline(in, linea)){
+        const size_t ini = linea.find_first_not_of(" \t\r");
+        if(ini == std::string::npos || linea[ini] == '#') continue;
+        puntos.push_back(linea.substr(ini));
+    }
+    return puntos;
+}
+
+/*
+metodo: run
+descripcion: Simula todos los puntos. El tamaño de equipo es el que justifica la red mediana del barrido y se
+             forman hebras_totales / tamaño equipos con una región paralela externa; cada punto usa
+             min(threadsFor(su red), tamaño) hebras en la región anidada. Los puntos se reparten de mayor a menor
+             red con schedule dynamic para que los grandes no queden al final. Cada equipo guarda sus redes por
+             topología (como el modo servidor) y las reinicia entre puntos. Si hay telemetría, cada equipo registra
+             sus pasos en su propio fragmento de contadores
+retorno: un resultado por punto, en el orden de entrada
+*/
+std::vector<ParameterSweep::Resultado> ParameterSweep::run(const std::vector<std::string>& puntos, int hebras_totales,
+                                                           int& equipos, int& hebras_equipo, Telemetry* telemetry){
+    const int P = static_cast<int>(puntos.size());
+    std::vector<Resultado> res(P);
+    if(P == 0){
+        equipos = hebras_equipo = 0;
+        return res;
+    }
+
+    std::vector<SimulationJob> trabajos;
+    trabajos.reserve(P);
+    for(int k = 0; k < P; ++k){
+        trabajos.emplace_back(puntos[k]);
+        res[k].linea = puntos[k];
+        res[k].nodos = nodosDe(trabajos[k]);
+    }
+
+    std::vector<int> orden(P);
+    std::iota(orden.begin(), orden.end(), 0);
+    std::stable_sort(orden.begin(), orden.end(), [&](int x, int y){ return res[x].nodos > res[y].nodos; });
+
+    hebras_equipo = threadsFor(res[orden[P / 2]].nodos, hebras_totales);
+    equipos = std::max(1, std::min(P, hebras_totales / hebras_equipo));
+
+    //La calibración de la política de ejecución se mide antes de abrir los equipos, con la máquina libre
+    ExecutionPolicy::calibration();
+
+    const int niveles_previos = omp_get_max_active_levels();
+    omp_set_max_active_levels(2);
+
+    #pragma omp parallel num_threads(equipos)
+    {
+        const int equipo = omp_get_thread_num();
+        std::map<std::string, std::unique_ptr<Network>> redes;
+
+        #pragma omp for schedule(dynamic, 1)
+        for(int k = 0; k < P; ++k){
+            const int p = orden[k];
+            const SimulationJob& job = trabajos[p];
+            Resultado& r = res[p];
+            r.equipo = equipo;
+            r.hebras = std::min(threadsFor(r.nodos, hebras_totales), hebras_equipo);
+            omp_set_num_threads(r.hebras);
+
+            try{
+                auto it = redes.find(job.topologyKey());
+                if(it == redes.end()) it = redes.emplace(job.topologyKey(), SimulationServer::buildNetwork(job)).first;
+                else it->second->resetState();
+                Network& net = *it->second;
+                SimulationServer::configureNetwork(net, job);
+                SimulationServer::applySource(net, job);
+
+                const int N = net.getSize();
+                const int steps = job.getInt("steps", 1000);
+                const int schedule = job.getInt("schedule", 0);
+                const int chunk = job.getInt("chunk", 0);
+                const double tol = job.getDouble("tol", 0.0);
+                const int pulse = job.getInt("pulse", N/2);
+                if(pulse < 0 || pulse >= N){
+                    throw std::out_of_range("pulse=" + std::to_string(pulse) + " fuera de la red (N=" +
+                                            std::to_string(N) + ")");
+                }
+                net.setAmplitude(pulse, job.getDouble("pulse_amp", 1.0));
+                net.setConvergenceMonitor(tol > 0.0);
+
+                const double t0 = omp_get_wtime();
+                for(int step = 1; step <= steps; ++step){
+                    const double t_paso = omp_get_wtime();
+                    if(chunk > 0) net.propagateWaves(schedule, chunk);
+                    else          net.propagateWaves(schedule);
+                    if(telemetry) telemetry->recordStep(N, omp_get_wtime() - t_paso);
+                    r.pasos = step;
+                    if(tol > 0.0 && net.getLastMaxChange() < tol){
+                        r.estacionario = step;
+                        break;
+                    }
+                }
+                r.segundos = omp_get_wtime() - t0;
+
+                const std::vector<double>& A = net.getAmplitudes();
+                r.energia = MetricsCalculator::CalcularEnergiaReproducible(A);
+                r.promedio = MetricsCalculator::CalcularSumaReproducible(A) / N;
+                for(double v : A) r.max_abs = std::max(r.max_abs, std::fabs(v));
+                net.setConvergenceMonitor(false);
+            } catch(const std::exception& e){
+                r.error = e.what();
+            }
+        }
+    }
+
+    omp_set_max_active_levels(niveles_previos);
+    omp_set_num_threads(hebras_totales);
+    return res;
+}
+
+/*
+metodo: write
+descripcion: Escribe la tabla de resultados del barrido, una fila por punto en el orden de entrada
+retorno: -
+*/
+void ParameterSweep::write(const std::string& path, const std::vector<Resultado>& res, int equipos, int hebras_equipo,
+                           double segundos){
+    std::ofstream out(path);
+    if(!out.is_open()){
+        std::cerr << "No se pudo abrir " << path << "\n";
+        return;
+    }
+    double actualizaciones = 0.0;
+    for(const Resultado& r : res) actualizaciones += static_cast<double>(r.nodos) * r.pasos;
+
+    out << "# puntos " << res.size() << " equipos " << equipos << " hebras_por_equipo " << hebras_equipo
+        << " tiempo " << std::scientific << std::setprecision(6) << segundos
+        << " actualizaciones_por_s " << (segundos > 0.0 ? actualizaciones / segundos : 0.0) << "\n";
+    out << "# punto D gamma dt fuente nodos pasos hebras equipo energia promedio max_abs estacionario segundos\n";
+    for(size_t k = 0; k < res.size(); ++k){
+        const Resultado& r = res[k];
+        const SimulationJob job(r.linea);
+        out << k << " " << std::defaultfloat << job.getDouble("D", 0.1) << " " << job.getDouble("gamma", 0.01)
+            << " " << job.getDouble("dt", 0.01) << " " << job.get("source", "fixed") << " " << r.nodos;
+        if(!r.error.empty()){
+            out << " error " << r.error << "\n";
+            continue;
+        }
+        out << " " << r.pasos << " " << r.hebras << " " << r.equipo << std::scientific << std::setprecision(6)
+            << " " << r.energia << " " << r.promedio << " " << r.max_abs << " " << r.estacionario
+            << " " << r.segundos << "\n";
+    }
+}
+
+/*
+metodo: runSweep
+descripcion: Lee los puntos de path, los simula repartiendo las hebras en equipos y escribe la tabla en out_path.
+             telemetry (opcional) recibe los pasos de todos los equipos mientras corren
+retorno: 0 si todos los puntos terminaron bien, 1 si no
+*/
+int ParameterSweep::runSweep(const std::string& path, const std::string& out_path, Telemetry* telemetry){
+    const std::vector<std::string> puntos = readPoints(path);
+    if(puntos.empty()){
+        std::cerr << "El barrido no tiene puntos\n";
+        return 1;
+    }
+    FileManagement::crearCarpeta();
+
+    const int hebras_totales = omp_get_max_threads();
+    int equipos = 0, hebras_equipo = 0;
+    const double t0 = omp_get_wtime();
+    const std::vector<Resultado> res = run(puntos, hebras_totales, equipos, hebras_equipo, telemetry);
+    const double segundos = omp_get_wtime() - t0;
+    write(out_path, res, equipos, hebras_equipo, segundos);
+
+    int errores = 0;
+    for(const Resultado& r : res){
+        if(!r.error.empty()){
+            ++errores;
+            std::cerr << "Error en el punto \"" << r.linea << "\": " << r.error << "\n";
+        }
+    }
+    std::cout << puntos.size() << " puntos en " << equipos << " equipos de " << hebras_equipo << " hebras ("
+              << segundos << " s). Resultados en '" << out_path << "'." << std::endl;
+    return errores > 0 ? 1 : 0;
+}
@@ -0,0 +1,49 @@
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+
+#include <string>
+#include <vector>
+
+class Telemetry;
+
+/*
+Abstracción:
+Barrido de parametros en un solo proceso. Cada punto es una linea "clave=valor ..." con las mismas claves del modo
+servidor (D, gamma, dt, source, steps, dims, n, w, h, ...). Las hebras disponibles se reparten en equipos (paralelismo
+anidado de OpenMP): cada equipo toma puntos de una cola y los simula con tantas hebras como justifique el tamaño de su
+red, así las redes pequeñas se ejecutan concurrentemente en vez de usar todos los núcleos cada una
+*/
+
+class ParameterSweep{
+public:
+    //Resultado de un punto del barrido
+    struct Resultado{
+        std::string linea;
+        int nodos = 0;
+        int hebras = 0;
+        int equipo = 0;
+        int pasos = 0;
+        int estacionario = 0;       // paso en que se alcanzó el estado estacionario (0 si no aplica)
+        double energia = 0.0;
+        double promedio = 0.0;
+        double max_abs = 0.0;
+        double segundos = 0.0;
+        std::string error;
+    };
+
+    static constexpr int kNodosPorHebra = 16384;   // bajo esto una hebra más cuesta más de lo que aporta
+
+    //otros metodos
+    static int runSweep(const std::string& path, const std::string& out_path, Telemetry* telemetry = nullptr);
+    static std::vector<Resultado> run(const std::vector<std::string>& puntos, int hebras_totales,
+                                      int& equipos, int& hebras_equipo, Telemetry* telemetry = nullptr);
+    static int threadsFor(int nodos, int hebras_totales);
+    static void write(const std::string& path, const std::vector<Resultado>& res, int equipos, int hebras_equipo,
+                      double segundos);
+
+private:
+    //otros metodos privados
+    static std::vector<std::string> readPoints(const std::string& path);
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <numeric>
+
+#include "SellCSigma.h"
+#include "Node.h"
+
+//En x86 la suma por tramo tiene una versión AVX2 con instrucciones gather explícitas, que se elige en tiempo de
+//ejecución si la CPU la soporta (sin compilar todo con -march=native)
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define SELL_AVX2 1
+#endif
+
+/*
+metodo: build
+descripcion: Construye la representación: dentro de cada ventana de sigma nodos se ordenan por grado de mayor a
+             menor (orden estable), se cortan tramos de kC nodos y cada tramo se rellena hasta su grado máximo
+retorno: -
+*/
+void SellCSigma::build(const std::vector<Node>& nodes, int sigma){
+    const int N = static_cast<int>(nodes.size());
+    sigma = std::max(kC, sigma - sigma % kC);
+    std::vector<int> orden(N);
+    std::iota(orden.begin(), orden.end(), 0);
+    for(int v = 0; v < N; v += sigma){
+        const int fin = std::min(N, v + sigma);
+        std::stable_sort(orden.begin() + v, orden.begin() + fin, [&](int x, int y){
+            return nodes[x].getDegree() > nodes[y].getDegree();
+        });
+    }
+
+    const int S = (N + kC - 1) / kC;
+    filas.assign(static_cast<size_t>(S) * kC, -1);
+    ancho.assign(S, 0);
+    inicio.assign(S + 1, 0);
+    aristas = 0;
+    for(int s = 0; s < S; ++s){
+        int w = 0;
+        for(int l = 0; l < kC && s * kC + l < N; ++l){
+            const int i = orden[s * kC + l];
+            filas[static_cast<size_t>(s) * kC + l] = i;
+            w = std::max(w, nodes[i].getDegree());
+            aristas += nodes[i].getDegree();
+        }
+        ancho[s] = w;
+        inicio[s + 1] = inicio[s] + static_cast<size_t>(w) * kC;
+    }
+
+    col.assign(inicio[S], 0);
+    #pragma omp parallel for schedule(static)
+    for(int s = 0; s < S; ++s){
+        int* c = col.data() + inicio[s];
+        for(int l = 0; l < kC; ++l){
+            const int i = filas[static_cast<size_t>(s) * kC + l];
+            const int propio = (i >= 0) ? i : 0;
+            const std::vector<int>* vecinos = (i >= 0) ? &nodes[i].getNeighbors() : nullptr;
+            const int grado = vecinos ? static_cast<int>(vecinos->size()) : 0;
+            for(int j = 0; j < ancho[s]; ++j) c[static_cast<size_t>(j) * kC + l] = (j < grado) ? (*vecinos)[j] : propio;
+        }
+    }
+}
+
+/*
+metodo: clear
+descripcion: Libera la representación
+retorno: -
+*/
+void SellCSigma::clear(){
+    std::vector<int>().swap(filas);
+    std::vector<size_t>().swap(inicio);
+    std::vector<int>().swap(ancho);
+    std::vector<int>().swap(col);
+    aristas = 0;
+}
+
+/*
+metodo: bytes
+descripcion: Memoria de la representación
+retorno: bytes
+*/
+size_t SellCSigma::bytes() const {
+    return (filas.capacity() + ancho.capacity() + col.capacity()) * sizeof(int) + inicio.capacity() * sizeof(size_t);
+}
+
+/*
+metodo: fillEfficiency
+descripcion: Fracción de las entradas guardadas que son aristas reales (1 = sin relleno)
+retorno: double entre 0 y 1
+*/
+double SellCSigma::fillEfficiency() const {
+    return col.empty() ? 1.0 : static_cast<double>(aristas) / static_cast<double>(col.size());
+}
+
+#ifdef SELL_AVX2
+/*
+metodo: sumasAvx2
+descripcion: Suma por tramo con AVX2: los 8 carriles van en dos registros de 4 doubles y cada columna se lee con
+             dos gathers de 4 vecinos. Cada carril hace las mismas operaciones (resta y suma) que la versión escalar
+retorno: -
+*/
+__attribute__((target("avx2")))
+static void sumasAvx2(const double* a, const int* cols, int width, const double* A, double* suma){
+    static_assert(SellCSigma::kC == 8, "la version AVX2 asume tramos de 8 nodos");
+    const __m256d A0 = _mm256_loadu_pd(A);
+    const __m256d A1 = _mm256_loadu_pd(A + 4);
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    const __m256d cero = _mm256_setzero_pd();
+    const __m256d todos = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    for(int j = 0; j < width; ++j){
+        const int* c = cols + static_cast<size_t>(j) * 8;
+        const __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c));
+        const __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + 4));
+        s0 = _mm256_add_pd(s0, _mm256_sub_pd(_mm256_mask_i32gather_pd(cero, a, c0, todos, 8), A0));
+        s1 = _mm256_add_pd(s1, _mm256_sub_pd(_mm256_mask_i32gather_pd(cero, a, c1, todos, 8), A1));
+    }
+    _mm256_storeu_pd(suma, s0);
+    _mm256_storeu_pd(suma + 4, s1);
+}
+#endif
+
+/*
+metodo: sumasGenericas
+descripcion: Suma por tramo portable (el compilador la vectoriza si el objetivo tiene gather)
+retorno: -
+*/
+static void sumasGenericas(const double* a, const int* cols, int width, const double* A, double* suma){
+    constexpr int C = SellCSigma::kC;
+    double s[C];
+    for(int l = 0; l < C; ++l) s[l] = 0.0;
+    for(int j = 0; j < width; ++j){
+        const int* c = cols + static_cast<size_t>(j) * C;
+        #pragma omp simd
+        for(int l = 0; l < C; ++l) s[l] += a[c[l]] - A[l];
+    }
+    for(int l = 0; l < C; ++l) suma[l] = s[l];
+}
+
+/*
+metodo: sliceSums
+descripcion: Suma de (A_vecino - A) de los kC nodos de un tramo. Cada columna j es un gather de kC vecinos; los
+             vecinos de cada nodo se suman en el mismo orden que en su lista
+retorno: -
+*/
+void SellCSigma::sliceSums(const double* a, const int* cols, int width, const double* A, double* suma){
+#ifdef SELL_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if(avx2){
+        sumasAvx2(a, cols, width, A, suma);
+        return;
+    }
+#endif
+    sumasGenericas(a, cols, width, A, suma);
+}
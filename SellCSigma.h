@@ -0,0 +1,45 @@
+#ifndef SELLCSIGMA_H
+#define SELLCSIGMA_H
+
+#include <cstddef>
+#include <vector>
+
+class Node;
+
+/*
+Abstracción:
+Representación SELL-C-sigma (ELLPACK por tramos) de una topología explícita. Los nodos se ordenan por grado
+dentro de ventanas de sigma nodos y se agrupan en tramos de C nodos; cada tramo guarda sus vecinos por columnas
+(el vecino j de los C nodos queda contiguo) con el ancho del nodo de mayor grado del tramo. Así el kernel avanza
+C nodos a la vez y lee sus vecinos con una instrucción gather por columna. Los huecos apuntan al propio nodo, que
+aporta (A - A) = 0 y deja el resultado idéntico al de las listas de vecinos
+*/
+
+class SellCSigma{
+public:
+    static constexpr int kC = 8;                 // nodos por tramo (un vector AVX-512 de doubles)
+    static constexpr int kSigmaDefecto = 256;    // ventana de ordenamiento por grado
+
+    //getters
+    int getSlices() const { return static_cast<int>(ancho.size()); }
+    const int* rows(int s) const { return filas.data() + static_cast<size_t>(s) * kC; }    // -1 en los huecos
+    const int* columns(int s) const { return col.data() + inicio[s]; }
+    int width(int s) const { return ancho[s]; }
+    size_t bytes() const;
+    double fillEfficiency() const;
+
+    //otros metodos
+    void build(const std::vector<Node>& nodes, int sigma = kSigmaDefecto);
+    void clear();
+    static void sliceSums(const double* a, const int* cols, int width, const double* A, double* suma);
+
+private:
+    //datos privados
+    std::vector<int> filas;         // nodo de cada carril, tramos * kC
+    std::vector<size_t> inicio;     // desplazamiento de cada tramo en col
+    std::vector<int> ancho;         // ancho (grado máximo) de cada tramo
+    std::vector<int> col;           // vecinos por columnas: col[inicio[s] + j * kC + carril]
+    long long aristas = 0;          // medias aristas reales (sin relleno)
+};
+
+#endif
@@ -0,0 +1,389 @@
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <omp.h>
+
+#include "SimulationServer.h"
+#include "Autotuner.h"
+#include "MetricsCalculator.h"
+#include "ExecutionPolicy.h"
+
+/*
+metodo: SimulationJob
+descripcion: Constructor, separa la linea del trabajo en pares clave=valor
+retorno: -
+*/
+SimulationJob::SimulationJob(const std::string& linea){
+    std::istringstream in(linea);
+    std::string tok;
+    while(in >> tok){
+        size_t eq = tok.find('=');
+        if(eq == std::string::npos) params[tok] = "";
+        else params[tok.substr(0, eq)] = tok.substr(eq + 1);
+    }
+}
+
+/*
+metodo: get
+descripcion: Obtiene el valor de un parametro como string
+retorno: el valor o def si no existe
+*/
+const std::string& SimulationJob::get(const std::string& key, const std::string& def) const {
+    auto it = params.find(key);
+    return (it != params.end()) ? it->second : def;
+}
+
+/*
+metodo: getDouble
+descripcion: Obtiene el valor de un parametro como double
+retorno: el valor o def si no existe
+*/
+double SimulationJob::getDouble(const std::string& key, double def) const {
+    auto it = params.find(key);
+    return (it != params.end()) ? std::stod(it->second) : def;
+}
+
+/*
+metodo: getInt
+descripcion: Obtiene el valor de un parametro como entero
+retorno: el valor o def si no existe
+*/
+int SimulationJob::getInt(const std::string& key, int def) const {
+    auto it = params.find(key);
+    return (it != params.end()) ? std::stoi(it->second) : def;
+}
+
+/*
+metodo: topologyKey
+descripcion: Llave con la que se guarda la red en el cache (la misma que usa el autotuner)
+retorno: string con la llave
+*/
+std::string SimulationJob::topologyKey() const {
+    const int dims = getInt("dims", 1);
+    return Autotuner::makeKey(dims, getInt("n", 100), getInt("w", 0), getInt("h", 0), getInt("d", 1),
+                              get("boundary", "open") == "periodic");
+}
+
+/*
+metodo: SimulationServer
+descripcion: Constructor del servidor
+retorno: -
+*/
+SimulationServer::SimulationServer(const std::string& socket_path) : socket_path(socket_path) {}
+
+/*
+metodo: buildNetwork
+descripcion: Construye la red regular pedida en el trabajo (dims, n o w/h/d y boundary)
+retorno: la red construida
+*/
+std::unique_ptr<Network> SimulationServer::buildNetwork(const SimulationJob& job){
+    const int dims = job.getInt("dims", 1);
+    const int w = job.getInt("w", 0);
+    const int h = job.getInt("h", 0);
+    const int d = job.getInt("d", 1);
+    const int n = (dims == 3) ? w * h * d : (dims == 2) ? w * h : job.getInt("n", 100);
+    const bool periodic = (job.get("boundary", "open") == "periodic");
+
+    auto net = std::make_unique<Network>(n, 0.0, 0.0);
+    net->initializeRegularNetwork(dims, w, h, d,
+                                  periodic ? Network::Boundary::Periodic : Network::Boundary::Open);
+    return net;
+}
+
+/*
+metodo: configureNetwork
+descripcion: Aplica los coeficientes del trabajo (D, gamma y dt) a la red
+retorno: -
+*/
+void SimulationServer::configureNetwork(Network& net, const SimulationJob& job){
+    net.setDiffusionCoeff(job.getDouble("D", 0.1));
+    net.setDampingCoeff(job.getDouble("gamma", 0.01));
+    net.setTimeStep(job.getDouble("dt", 0.01));
+}
+
+/*
+metodo: acquireNetwork
+descripcion: Devuelve la red de la topología pedida, construyéndola solo la primera vez.
+             Las redes del cache se reinician (amplitudes y tiempo en cero) antes de cada trabajo. El cache guarda
+             a lo más kMaxRedes redes: para una topología nueva con el cache lleno se descarta la menos usada
+retorno: referencia a la red
+*/
+Network& SimulationServer::acquireNetwork(const SimulationJob& job){
+    const std::string key = job.topologyKey();
+    auto it = cache.find(key);
+    if(it == cache.end()){
+        std::unique_ptr<Network> red = buildNetwork(job);
+        if(cache.size() >= kMaxRedes){
+            auto viejo = std::min_element(cache.begin(), cache.end(), [](const auto& x, const auto& y){
+                return x.second.uso < y.second.uso;
+            });
+            cache.erase(viejo);
+        }
+        it = cache.emplace(key, Entrada{std::move(red), 0}).first;
+    } else {
+        it->second.red->resetState();
+    }
+    it->second.uso = ++usos;
+
+    Network& net = *it->second.red;
+    configureNetwork(net, job);
+    return net;
+}
+
+/*
+metodo: applySource
+descripcion: Configura la fuente externa pedida en el trabajo (zero, fixed, random, sine o points).
+             points=nodo:valor[:amp:omega],... define fuentes puntuales
+retorno: -
+*/
+void SimulationServer::applySource(Network& net, const SimulationJob& job){
+    const std::string fuente = job.get("source", "fixed");
+    net.clearPointSources();
+    if(fuente == "points"){
+        std::stringstream lista(job.get("points", ""));
+        std::string item;
+        while(std::getline(lista, item, ',')){
+            std::stringstream campos(item);
+            std::string campo;
+            double v[4] = {0.0, 0.0, 0.0, 0.0};
+            int k = 0;
+            while(k < 4 && std::getline(campos, campo, ':')) v[k++] = std::stod(campo);
+            if(k < 2) throw std::runtime_error("Fuente puntual invalida: " + item);
+            net.addPointSource(static_cast<int>(v[0]), v[1], v[2], v[3]);
+        }
+        if(net.getPointSourceCount() == 0) net.setZeroSource();
+    } else if(fuente == "zero"){
+        net.setZeroSource();
+    } else if(fuente == "random"){
+        net.generateRandomSources(job.getDouble("min", -0.05), job.getDouble("max", 0.05),
+                                  static_cast<unsigned>(job.getInt("seed", 1234)));
+    } else if(fuente == "sine"){
+        net.setSineSource(job.getDouble("amp", 0.1), job.getDouble("omega", 2.0 * M_PI));
+    } else {
+        net.setSources(std::vector<double>(net.getSize(), job.getDouble("value", 0.05)));
+    }
+}
+
+/*
+metodo: runJob
+descripcion: Ejecuta un trabajo completo sobre una red del cache y aplica la política de salida:
+             output=none (solo respuesta), energy (energía por paso en path) o final (estado final en path)
+retorno: linea de respuesta para el cliente
+*/
+std::string SimulationServer::runJob(const SimulationJob& job){
+    Network& net = acquireNetwork(job);
+    applySource(net, job);
+
+    const int N = net.getSize();
+    const int steps = job.getInt("steps", 1000);
+    const std::string output = job.get("output", "none");
+    const std::string path = job.get("path", "");
+    const double tol = job.getDouble("tol", 0.0);
+
+    const int pulse = job.getInt("pulse", N/2);
+    if(pulse < 0 || pulse >= N){
+        return "error pulse=" + std::to_string(pulse) + " fuera de la red (N=" + std::to_string(N) + ")";
+    }
+
+    //Las hebras y el modo de ejecución valen solo para este trabajo: se restauran al salir, también con error
+    struct Restaurar{
+        int hebras;
+        ExecutionPolicy::Mode modo;
+        ~Restaurar(){
+            omp_set_num_threads(hebras);
+            ExecutionPolicy::setMode(modo);
+        }
+    } restaurar{omp_get_max_threads(), ExecutionPolicy::getMode()};
+
+    //Paralelización: parametros del trabajo o, si no vienen, la configuración autotuneada (medida en modo parallel)
+    int schedule = job.getInt("schedule", -1);
+    int chunk = job.getInt("chunk", 0);
+    int threads = job.getInt("threads", 0);
+    if(schedule < 0){
+        schedule = 0;
+        TuningConfig tuned;
+        if(Autotuner::lookup(Autotuner::kTuningPath, job.topologyKey(),
+                             Autotuner::machineFingerprint(), tuned) && tuned.getVariant() == 0){
+            schedule = tuned.getSchedule();
+            chunk = tuned.getChunk();
+            if(threads <= 0) threads = tuned.getThreads();
+            ExecutionPolicy::setMode(ExecutionPolicy::Mode::Parallel);
+        }
+    }
+    if(threads > 0) omp_set_num_threads(threads);
+
+    net.setAmplitude(pulse, job.getDouble("pulse_amp", 1.0));
+
+    std::ofstream out;
+    if(output != "none"){
+        if(path.empty()) return "error output=" + output + " requiere path=";
+        out.open(path);
+        if(!out.is_open()) return "error no se pudo abrir " + path;
+    }
+
+    auto energia = [&](){
+        return MetricsCalculator::CalcularEnergiaReproducible(net.getAmplitudes());
+    };
+
+    //solver=jacobi|ic0|mg: equilibrio directo en vez de integrar en el tiempo
+    if(job.has("solver")){
+        const SteadyStateSolver::Method metodo = SteadyStateSolver::parseMethod(job.get("solver", "ic0"));
+        const SteadyStateSolver::Result res = net.solveSteadyState(metodo, job.getDouble("tol", 1e-10),
+                                                                   job.getInt("max_iter", 10000));
+        if(output == "final"){
+            for(double a : net.getAmplitudes()){
+                out << std::scientific << std::setprecision(6) << a << "\n";
+            }
+        }
+        ++jobs_done;
+        std::ostringstream resp;
+        resp << (res.converged ? "ok" : "error") << " job=" << jobs_done
+             << " solver=" << SteadyStateSolver::methodName(metodo) << " iterations=" << res.iterations
+             << " residual=" << std::scientific << std::setprecision(6) << res.residual
+             << " energy=" << energia() << " time=" << res.seconds;
+        return resp.str();
+    }
+
+    //Con tol > 0 el trabajo termina cuando el cambio máximo por paso baja de tol (estado estacionario)
+    net.setConvergenceMonitor(tol > 0.0);
+    int pasos = 0;
+    bool estacionario = false;
+
+    double t0 = omp_get_wtime();
+    for(int step = 1; step <= steps; ++step){
+        if(chunk > 0) net.propagateWaves(schedule, chunk);
+        else          net.propagateWaves(schedule);
+        pasos = step;
+
+        if(output == "energy"){
+            out << step << " " << std::scientific << std::setprecision(6) << energia() << "\n";
+        }
+        if(tol > 0.0 && net.getLastMaxChange() < tol){
+            estacionario = true;
+            break;
+        }
+    }
+    const double duracion = omp_get_wtime() - t0;
+
+    if(output == "final"){
+        for(double a : net.getAmplitudes()){
+            out << std::scientific << std::setprecision(6) << a << "\n";
+        }
+    }
+
+    ++jobs_done;
+    std::ostringstream resp;
+    resp << "ok job=" << jobs_done << " steps=" << pasos;
+    if(estacionario) resp << " steady=" << pasos;
+    resp << " energy=" << std::scientific << std::setprecision(6) << energia()
+         << " time=" << duracion;
+    return resp.str();
+}
+
+/*
+metodo: enviar
+descripcion: Envía la respuesta completa (reintenta las escrituras parciales). Con MSG_NOSIGNAL un cliente que se
+             desconectó antes no genera SIGPIPE, que terminaría el servidor
+retorno: true si se envió todo
+*/
+static bool enviar(int cli, const std::string& resp){
+    size_t enviados = 0;
+    while(enviados < resp.size()){
+        const ssize_t n = send(cli, resp.data() + enviados, resp.size() - enviados, MSG_NOSIGNAL);
+        if(n <= 0) return false;
+        enviados += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/*
+metodo: run
+descripcion: Loop principal del servidor. Atiende una conexión a la vez; cada linea recibida es un trabajo
+             y se responde con una linea. El comando "shutdown" detiene el servidor
+retorno: entero que indica si funciona correctamente
+*/
+int SimulationServer::run(){
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0){
+        std::cerr << "Error: no se pudo crear el socket\n";
+        return 1;
+    }
+
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    //Solo se reemplaza un socket que haya quedado de una corrida anterior, nunca un archivo de otro tipo
+    struct stat st;
+    if(lstat(socket_path.c_str(), &st) == 0){
+        if(!S_ISSOCK(st.st_mode)){
+            std::cerr << "Error: " << socket_path << " existe y no es un socket\n";
+            close(fd);
+            return 1;
+        }
+        unlink(socket_path.c_str());
+    }
+
+    if(bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 16) < 0){
+        std::cerr << "Error: no se pudo escuchar en " << socket_path << "\n";
+        close(fd);
+        return 1;
+    }
+
+    //Se levanta el pool de hebras una vez, para que los trabajos no paguen ese costo
+    #pragma omp parallel
+    { }
+
+    std::cout << "Servidor escuchando en " << socket_path << std::endl;
+
+    bool activo = true;
+    while(activo){
+        int cli = accept(fd, nullptr, nullptr);
+        if(cli < 0) continue;
+
+        std::string buffer;
+        char chunk[4096];
+        ssize_t leidos;
+        while(activo && (leidos = read(cli, chunk, sizeof(chunk))) > 0){
+            buffer.append(chunk, leidos);
+            size_t nl;
+            while((nl = buffer.find('\n')) != std::string::npos){
+                std::string linea = buffer.substr(0, nl);
+                buffer.erase(0, nl + 1);
+                if(linea.empty()) continue;
+
+                std::string resp;
+                if(linea == "shutdown"){
+                    resp = "ok shutdown";
+                    activo = false;
+                } else {
+                    try {
+                        resp = runJob(SimulationJob(linea));
+                    } catch(const std::exception& e){
+                        resp = std::string("error ") + e.what();
+                    }
+                }
+                resp += "\n";
+                if(!enviar(cli, resp)) break;
+                if(!activo) break;
+            }
+        }
+        close(cli);
+    }
+
+    close(fd);
+    unlink(socket_path.c_str());
+    return 0;
+}
@@ -0,0 +1,67 @@
+#ifndef SIMULATIONSERVER_H
+#define SIMULATIONSERVER_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "Network.h"
+
+/*
+Abstracción:
+Modo servidor: un proceso de larga duración que recibe trabajos de simulación por un socket Unix local,
+mantiene el pool de hebras de OpenMP activo y reutiliza las redes ya construidas entre trabajos
+*/
+
+class SimulationJob{
+public:
+    //Constructor a partir de una linea "clave=valor clave=valor ..."
+    explicit SimulationJob(const std::string& linea);
+
+    //getters
+    const std::string& get(const std::string& key, const std::string& def) const;
+    double getDouble(const std::string& key, double def) const;
+    int getInt(const std::string& key, int def) const;
+    bool has(const std::string& key) const { return params.count(key) > 0; }
+    std::string topologyKey() const;
+
+private:
+    //datos privados
+    std::map<std::string, std::string> params;
+};
+
+class SimulationServer{
+public:
+    static constexpr size_t kMaxRedes = 8;     // redes en cache; al llenarse se descarta la menos usada recientemente
+
+    //Constructor
+    explicit SimulationServer(const std::string& socket_path);
+
+    //otros metodos
+    int run();
+    std::string runJob(const SimulationJob& job);
+
+    //Construcción y configuración de una red a partir de un trabajo (también las usa el barrido de parametros)
+    static std::unique_ptr<Network> buildNetwork(const SimulationJob& job);
+    static void configureNetwork(Network& net, const SimulationJob& job);
+    static void applySource(Network& net, const SimulationJob& job);
+
+private:
+    //Red del cache y el último trabajo que la usó
+    struct Entrada{
+        std::unique_ptr<Network> red;
+        uint64_t uso = 0;
+    };
+
+    //datos privados
+    std::string socket_path;
+    std::map<std::string, Entrada> cache;      // redes construidas por llave de topología
+    uint64_t usos = 0;
+    int jobs_done = 0;
+
+    //otros metodos privados
+    Network& acquireNetwork(const SimulationJob& job);
+};
+
+#endif
@@ -0,0 +1,219 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "SnapshotRing.h"
+#include "MetricsCalculator.h"
+
+/*
+metodo: SnapshotRing
+descripcion: Constructor del escritor: crea (o reemplaza) el segmento compartido con la cantidad de ranuras pedida
+retorno: -
+*/
+SnapshotRing::SnapshotRing(const std::string& name, uint64_t num_nodes, uint32_t slots, int w, int h, int d)
+    : nombre(name), escritor(true)
+{
+    bytes_ranura = sizeof(Slot) + num_nodes * sizeof(double);
+    largo = sizeof(Header) + static_cast<size_t>(slots) * bytes_ranura;
+
+    shm_unlink(nombre.c_str());
+    fd = shm_open(nombre.c_str(), O_CREAT | O_RDWR, 0644);
+    if(fd < 0 || ftruncate(fd, static_cast<off_t>(largo)) != 0){
+        release();
+        throw std::runtime_error("No se pudo crear la memoria compartida " + nombre);
+    }
+    void* p = mmap(nullptr, largo, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(p == MAP_FAILED){
+        release();
+        throw std::runtime_error("No se pudo mapear " + nombre);
+    }
+    base = static_cast<char*>(p);
+
+    cabecera = new (base) Header();
+    cabecera->slots = slots;
+    cabecera->dims[0] = w;
+    cabecera->dims[1] = h;
+    cabecera->dims[2] = d;
+    cabecera->num_nodes = num_nodes;
+    cabecera->published.store(0, std::memory_order_relaxed);
+    cabecera->closed.store(0, std::memory_order_relaxed);
+    for(uint32_t k = 0; k < slots; ++k){
+        Slot* s = new (base + sizeof(Header) + k * bytes_ranura) Slot();
+        s->seq.store(0, std::memory_order_relaxed);
+    }
+    //El magic se escribe al final para que los lectores no vean un segmento a medio inicializar
+    std::atomic_thread_fence(std::memory_order_release);
+    cabecera->magic = kMagic;
+}
+
+/*
+metodo: SnapshotRing
+descripcion: Constructor del lector: abre un segmento existente en solo lectura y comprueba que su tamaño alcance
+             para las ranuras que declara la cabecera
+retorno: -
+*/
+SnapshotRing::SnapshotRing(const std::string& name) : nombre(name), escritor(false) {
+    fd = shm_open(nombre.c_str(), O_RDONLY, 0);
+    if(fd < 0) throw std::runtime_error("No existe la memoria compartida " + nombre);
+    struct stat st;
+    if(fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)){
+        release();
+        throw std::runtime_error("Segmento invalido: " + nombre);
+    }
+    largo = static_cast<size_t>(st.st_size);
+    void* p = mmap(nullptr, largo, PROT_READ, MAP_SHARED, fd, 0);
+    if(p == MAP_FAILED){
+        release();
+        throw std::runtime_error("No se pudo mapear " + nombre);
+    }
+    base = static_cast<char*>(p);
+    cabecera = reinterpret_cast<Header*>(base);
+
+    //Tamaño de ranura disponible por división, para que una cabecera corrupta no desborde el cálculo
+    const uint64_t slots = cabecera->slots;
+    const size_t por_ranura = (slots > 0) ? (largo - sizeof(Header)) / slots : 0;
+    if(cabecera->magic != kMagic || slots == 0 || por_ranura < sizeof(Slot) ||
+       cabecera->num_nodes > (por_ranura - sizeof(Slot)) / sizeof(double)){
+        release();
+        throw std::runtime_error("Segmento invalido: " + nombre);
+    }
+    bytes_ranura = sizeof(Slot) + cabecera->num_nodes * sizeof(double);
+}
+
+/*
+metodo: release
+descripcion: Libera el mapeo y el descriptor (también en los errores del constructor, donde no corre el destructor)
+retorno: -
+*/
+void SnapshotRing::release(){
+    if(base) munmap(base, largo);
+    if(fd >= 0) ::close(fd);
+    base = nullptr;
+    cabecera = nullptr;
+    fd = -1;
+}
+
+/*
+metodo: ~SnapshotRing
+descripcion: Destructor, el escritor marca el anillo como cerrado. El segmento no se borra para que los
+             lectores puedan leer el último cuadro; se reemplaza en la siguiente corrida
+retorno: -
+*/
+SnapshotRing::~SnapshotRing(){
+    if(escritor && cabecera) close();
+    release();
+}
+
+/*
+metodo: slot
+descripcion: Puntero a la ranura k
+retorno: puntero a Slot
+*/
+SnapshotRing::Slot* SnapshotRing::slot(uint32_t k) const {
+    return reinterpret_cast<Slot*>(base + sizeof(Header) + k * bytes_ranura);
+}
+
+/*
+metodo: frameData
+descripcion: Puntero a los datos de la ranura (lectura sin copia; validar con la secuencia de la ranura)
+retorno: puntero a los doubles de la ranura
+*/
+const double* SnapshotRing::frameData(uint32_t k) const {
+    return reinterpret_cast<const double*>(reinterpret_cast<const char*>(slot(k)) + sizeof(Slot));
+}
+
+/*
+metodo: publish
+descripcion: Publica un cuadro en la siguiente ranura. Secuencia impar mientras se copia y par al terminar
+retorno: -
+*/
+void SnapshotRing::publish(uint64_t step, double time, StateView A){
+    const uint64_t n = cabecera->published.load(std::memory_order_relaxed);
+    Slot* s = slot(static_cast<uint32_t>(n % cabecera->slots));
+
+    const uint64_t seq = s->seq.load(std::memory_order_relaxed);
+    s->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    s->step = step;
+    s->time = time;
+    std::memcpy(const_cast<double*>(frameData(static_cast<uint32_t>(n % cabecera->slots))), A.data(),
+                std::min<size_t>(A.size(), cabecera->num_nodes) * sizeof(double));
+
+    s->seq.store(seq + 2, std::memory_order_release);
+    cabecera->published.store(n + 1, std::memory_order_release);
+}
+
+/*
+metodo: close
+descripcion: Marca que el escritor terminó
+retorno: -
+*/
+void SnapshotRing::close(){
+    cabecera->closed.store(1, std::memory_order_release);
+}
+
+/*
+metodo: readLatest
+descripcion: Copia el último cuadro publicado validando el seqlock (reintenta si el escritor lo sobrescribió)
+retorno: true si se leyó un cuadro
+*/
+bool SnapshotRing::readLatest(std::vector<double>& out, uint64_t& step, double& time) const {
+    for(int intento = 0; intento < 100; ++intento){
+        const uint64_t n = cabecera->published.load(std::memory_order_acquire);
+        if(n == 0) return false;
+        const uint32_t k = static_cast<uint32_t>((n - 1) % cabecera->slots);
+        const Slot* s = slot(k);
+
+        const uint64_t s1 = s->seq.load(std::memory_order_acquire);
+        if(s1 & 1) continue;
+        step = s->step;
+        time = s->time;
+        out.assign(frameData(k), frameData(k) + cabecera->num_nodes);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t s2 = s->seq.load(std::memory_order_relaxed);
+        if(s1 == s2) return true;
+    }
+    return false;
+}
+
+/*
+metodo: runMonitor
+descripcion: Lector de ejemplo: cada 0.5 s imprime el paso, la energía y la amplitud máxima del último cuadro,
+             hasta que el escritor cierra el anillo
+retorno: entero que indica si funciona correctamente
+*/
+int SnapshotRing::runMonitor(const std::string& name){
+    try {
+        SnapshotRing ring(name);
+        std::vector<double> A;
+        uint64_t step = 0, ultimo = UINT64_MAX;
+        double t = 0.0;
+        while(true){
+            const bool cerrado = ring.header().closed.load(std::memory_order_acquire) != 0;
+            if(ring.readLatest(A, step, t) && step != ultimo){
+                double maximo = 0.0;
+                for(double a : A) maximo = std::max(maximo, std::fabs(a));
+                std::cout << "paso=" << step << " t=" << t
+                          << " energia=" << MetricsCalculator::CalcularEnergiaReproducible(A)
+                          << " max=" << maximo << std::endl;
+                ultimo = step;
+            }
+            if(cerrado) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+    } catch(const std::exception& e){
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#ifndef SNAPSHOTRING_H
+#define SNAPSHOTRING_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "StateView.h"
+
+/*
+Abstracción:
+Anillo de cuadros en memoria compartida POSIX (shm_open) para que otros procesos de la misma máquina lean
+el estado mientras la simulación sigue corriendo, sin pasar por archivos. Cada ranura se protege con un
+seqlock: el escritor deja la secuencia impar mientras copia y par al terminar; el lector valida que la
+secuencia no haya cambiado y sea par antes y después de leer
+*/
+
+class SnapshotRing{
+public:
+    //Cabecera del segmento (al inicio de la memoria compartida)
+    struct Header{
+        uint64_t magic;
+        uint32_t slots;
+        uint32_t dims[3];                 // ancho, alto, profundidad de la malla (1 si no aplica)
+        uint64_t num_nodes;
+        std::atomic<uint64_t> published;  // cantidad de cuadros publicados
+        std::atomic<uint32_t> closed;     // 1 cuando el escritor terminó
+    };
+
+    //Cabecera de cada ranura, seguida de num_nodes doubles
+    struct Slot{
+        std::atomic<uint64_t> seq;
+        uint64_t step;
+        double time;
+        uint64_t padding;
+    };
+
+    static constexpr uint64_t kMagic = 0x474e495257415645ULL;   // "EVAWRING"
+
+    //Constructores: escritor (crea el segmento) o lector (lo abre en solo lectura)
+    SnapshotRing(const std::string& name, uint64_t num_nodes, uint32_t slots, int w, int h, int d);
+    explicit SnapshotRing(const std::string& name);
+    ~SnapshotRing();
+    SnapshotRing(const SnapshotRing&) = delete;
+    SnapshotRing& operator=(const SnapshotRing&) = delete;
+
+    //getters
+    const Header& header() const { return *cabecera; }
+    const double* frameData(uint32_t slot) const;
+
+    //otros metodos
+    void publish(uint64_t step, double time, StateView A);
+    void close();
+    bool readLatest(std::vector<double>& out, uint64_t& step, double& time) const;
+
+    static int runMonitor(const std::string& name);
+
+private:
+    //datos privados
+    std::string nombre;
+    bool escritor;
+    int fd = -1;
+    char* base = nullptr;
+    size_t largo = 0;
+    Header* cabecera = nullptr;
+    size_t bytes_ranura = 0;
+
+    //otros metodos privados
+    Slot* slot(uint32_t k) const;
+    void release();
+};
+
+#endif
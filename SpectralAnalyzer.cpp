@@ -0,0 +1,119 @@
+#include <cmath>
+#include <complex>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "SpectralAnalyzer.h"
+
+/*
+metodo: SpectralAnalyzer
+descripcion: Constructor, reserva dos estados de Goertzel por nodo y frecuencia
+retorno: -
+*/
+SpectralAnalyzer::SpectralAnalyzer(int num_nodes, const std::vector<double>& frequencies, double dt,
+                                   int total_samples, bool hann_window)
+    : num_nodes(num_nodes), frecuencias(frequencies), dt(dt), total(total_samples), hann(hann_window)
+{
+    for(double f : frecuencias) coef.push_back(2.0 * std::cos(2.0 * M_PI * f * dt));
+    s1.assign(frecuencias.size() * num_nodes, 0.0);
+    s2.assign(frecuencias.size() * num_nodes, 0.0);
+}
+
+/*
+metodo: addSample
+descripcion: Agrega una muestra (el estado de un paso) a todas las frecuencias. Recurrencia de Goertzel:
+             s = w*x + 2cos(w) s1 - s2, en paralelo sobre los nodos
+retorno: -
+*/
+void SpectralAnalyzer::addSample(StateView A){
+    double w = 1.0;
+    if(hann && total > 1) w = 0.5 - 0.5 * std::cos(2.0 * M_PI * muestras / (total - 1));
+    suma_ventana += w;
+
+    const int K = static_cast<int>(frecuencias.size());
+    const int N = num_nodes;
+    for(int k = 0; k < K; ++k){
+        const double c = coef[k];
+        double* p1 = s1.data() + static_cast<size_t>(k) * N;
+        double* p2 = s2.data() + static_cast<size_t>(k) * N;
+        #pragma omp parallel for simd schedule(static)
+        for(int i = 0; i < N; ++i){
+            const double s = w * A[i] + c * p1[i] - p2[i];
+            p2[i] = p1[i];
+            p1[i] = s;
+        }
+    }
+    ++muestras;
+}
+
+/*
+metodo: componente
+descripcion: Componente compleja de Fourier de la frecuencia k en el nodo, normalizada por la suma de la ventana
+             (una sinusoide de amplitud a entrega |X| = a/2)
+retorno: complejo con la componente
+*/
+static std::complex<double> componente(double s1, double s2, double f, double dt, int n, double norm){
+    const double w = 2.0 * M_PI * f * dt;
+    std::complex<double> X = s1 - std::polar(1.0, -w) * s2;
+    //Corrección de fase para que sea relativa a la primera muestra
+    X *= std::polar(1.0, -w * (n - 1));
+    return (norm > 0.0) ? X / norm : X;
+}
+
+/*
+metodo: amplitude
+descripcion: Amplitud de la sinusoide de frecuencia k en el nodo (2|X|, y |X| para f = 0)
+retorno: double con la amplitud
+*/
+double SpectralAnalyzer::amplitude(int node, int k) const {
+    const size_t j = static_cast<size_t>(k) * num_nodes + node;
+    const double a = std::abs(componente(s1[j], s2[j], frecuencias[k], dt, muestras, suma_ventana));
+    return (frecuencias[k] == 0.0) ? a : 2.0 * a;
+}
+
+/*
+metodo: phase
+descripcion: Fase de la componente de frecuencia k en el nodo (radianes)
+retorno: double con la fase
+*/
+double SpectralAnalyzer::phase(int node, int k) const {
+    const size_t j = static_cast<size_t>(k) * num_nodes + node;
+    return std::arg(componente(s1[j], s2[j], frecuencias[k], dt, muestras, suma_ventana));
+}
+
+/*
+metodo: write
+descripcion: Escribe la tabla compacta: una fila por nodo con amplitud y fase de cada frecuencia
+retorno: -
+*/
+void SpectralAnalyzer::write(const std::string& path) const {
+    std::ofstream f(path);
+    f << "# muestras=" << muestras << " dt=" << dt << (hann ? " ventana=hann" : " ventana=rectangular") << "\n";
+    f << "# Node";
+    for(double fr : frecuencias) f << " amp_" << fr << "Hz phase_" << fr << "Hz";
+    f << "\n";
+    for(int i = 0; i < num_nodes; ++i){
+        f << i;
+        for(size_t k = 0; k < frecuencias.size(); ++k){
+            f << " " << std::scientific << std::setprecision(6) << amplitude(i, static_cast<int>(k))
+              << " " << phase(i, static_cast<int>(k));
+        }
+        f << "\n";
+    }
+}
+
+/*
+metodo: parseFrequencies
+descripcion: Convierte una lista "0.5,1,2" en un vector de frecuencias
+retorno: vector con las frecuencias
+*/
+std::vector<double> SpectralAnalyzer::parseFrequencies(const std::string& lista){
+    std::vector<double> out;
+    std::stringstream ss(lista);
+    std::string tok;
+    while(std::getline(ss, tok, ',')){
+        if(!tok.empty()) out.push_back(std::stod(tok));
+    }
+    return out;
+}
@@ -0,0 +1,47 @@
+#ifndef SPECTRALANALYZER_H
+#define SPECTRALANALYZER_H
+
+#include <string>
+#include <vector>
+
+#include "StateView.h"
+
+/*
+Abstracción:
+Análisis espectral in situ: en vez de guardar la evolución completa de la onda, se calcula por nodo y de forma
+incremental la componente de Fourier de un conjunto de frecuencias elegidas (algoritmo de Goertzel), con una
+ventana de Hann opcional. Al final solo se escribe una tabla compacta con amplitud y fase por nodo y frecuencia
+*/
+
+class SpectralAnalyzer{
+public:
+    //Constructor: frecuencias en Hz, dt de la simulación y cantidad total de muestras (para la ventana)
+    SpectralAnalyzer(int num_nodes, const std::vector<double>& frequencies, double dt, int total_samples,
+                     bool hann_window = true);
+
+    //getters
+    int getSamples() const { return muestras; }
+    const std::vector<double>& getFrequencies() const { return frecuencias; }
+
+    //otros metodos
+    void addSample(StateView A);
+    double amplitude(int node, int k) const;
+    double phase(int node, int k) const;
+    void write(const std::string& path) const;
+
+    static std::vector<double> parseFrequencies(const std::string& lista);
+
+private:
+    //datos privados
+    int num_nodes;
+    std::vector<double> frecuencias;
+    std::vector<double> coef;      // 2 cos(w_k) por frecuencia
+    std::vector<double> s1, s2;    // estados de Goertzel, [k * num_nodes + i]
+    double dt;
+    int total;
+    bool hann;
+    int muestras = 0;
+    double suma_ventana = 0.0;
+};
+
+#endif
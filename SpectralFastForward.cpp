@@ -0,0 +1,239 @@
+#include <cmath>
+#include <stdexcept>
+#include <omp.h>
+
+#include "SpectralFastForward.h"
+#include "Network.h"
+
+/*
+metodo: Dct
+descripcion: Constructor, prepara los giros de la DCT y la FFT. Si n no es potencia de 2 la DFT de largo n se
+             calcula con el algoritmo de Bluestein (convolución con un chirp usando una FFT radix 2 de largo m)
+retorno: -
+*/
+Dct::Dct(int n_) : n(n_) {
+    bluestein = (n & (n - 1)) != 0;
+    m = 1;
+    if(bluestein) while(m < 2 * n - 1) m <<= 1;
+    else m = n;
+
+    giro.resize(n);
+    for(int k = 0; k < n; ++k) giro[k] = std::polar(1.0, -M_PI * k / (2.0 * n));
+
+    raices.resize(std::max(1, m / 2));
+    for(int t = 0; t < m / 2; ++t) raices[t] = std::polar(1.0, -2.0 * M_PI * t / m);
+
+    if(bluestein){
+        //exp(-i pi j^2 / n) con j^2 reducido módulo 2n para no perder precisión
+        chirp.resize(n);
+        for(int j = 0; j < n; ++j){
+            const long long j2 = (static_cast<long long>(j) * j) % (2LL * n);
+            chirp[j] = std::polar(1.0, -M_PI * static_cast<double>(j2) / n);
+        }
+        chirp_fft.assign(m, cd(0.0, 0.0));
+        chirp_fft[0] = std::conj(chirp[0]);
+        for(int j = 1; j < n; ++j){
+            chirp_fft[j] = std::conj(chirp[j]);
+            chirp_fft[m - j] = std::conj(chirp[j]);
+        }
+        fft(chirp_fft, false);
+        trabajo.resize(m);
+    }
+    v.resize(n);
+    linea.resize(n);
+}
+
+/*
+metodo: fft
+descripcion: FFT radix 2 iterativa en el lugar, de largo m. La inversa incluye el factor 1/m
+retorno: -
+*/
+void Dct::fft(std::vector<cd>& a, bool inversa) const {
+    //Permutación por inversión de bits
+    for(int i = 1, j = 0; i < m; ++i){
+        int bit = m >> 1;
+        for(; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if(i < j) std::swap(a[i], a[j]);
+    }
+    for(int len = 2; len <= m; len <<= 1){
+        const int paso = m / len;
+        for(int i = 0; i < m; i += len){
+            for(int k = 0; k < len / 2; ++k){
+                const cd w = inversa ? std::conj(raices[k * paso]) : raices[k * paso];
+                const cd u = a[i + k];
+                const cd t = w * a[i + k + len / 2];
+                a[i + k] = u + t;
+                a[i + k + len / 2] = u - t;
+            }
+        }
+    }
+    if(inversa){
+        const double escala = 1.0 / m;
+        for(int i = 0; i < m; ++i) a[i] *= escala;
+    }
+}
+
+/*
+metodo: dft
+descripcion: DFT de largo n (los primeros n elementos de a). La inversa incluye el factor 1/n
+retorno: -
+*/
+void Dct::dft(std::vector<cd>& a, bool inversa){
+    if(!bluestein){
+        fft(a, inversa);
+        return;
+    }
+    //La inversa es la conjugada de la directa sobre la entrada conjugada
+    if(inversa) for(int j = 0; j < n; ++j) a[j] = std::conj(a[j]);
+
+    for(int j = 0; j < n; ++j) trabajo[j] = a[j] * chirp[j];
+    for(int j = n; j < m; ++j) trabajo[j] = cd(0.0, 0.0);
+    fft(trabajo, false);
+    for(int j = 0; j < m; ++j) trabajo[j] *= chirp_fft[j];
+    fft(trabajo, true);
+    for(int k = 0; k < n; ++k) a[k] = trabajo[k] * chirp[k];
+
+    if(inversa){
+        const double escala = 1.0 / n;
+        for(int j = 0; j < n; ++j) a[j] = std::conj(a[j]) * escala;
+    }
+}
+
+/*
+metodo: forward
+descripcion: DCT-II de la línea x[0], x[stride], ..., con el reordenamiento de Makhoul (pares hacia adelante,
+             impares hacia atrás) y una DFT compleja de largo n
+retorno: -
+*/
+void Dct::forward(double* x, int stride){
+    for(int j = 0; 2 * j < n; ++j) v[j] = cd(x[(size_t)(2 * j) * stride], 0.0);
+    for(int j = 0; 2 * j + 1 < n; ++j) v[n - 1 - j] = cd(x[(size_t)(2 * j + 1) * stride], 0.0);
+    dft(v, false);
+    for(int k = 0; k < n; ++k) x[(size_t)k * stride] = (v[k] * giro[k]).real();
+}
+
+/*
+metodo: inverse
+descripcion: DCT-III normalizada (inversa de forward): V_k = exp(i pi k / 2n) (X_k - i X_{n-k}), luego DFT inversa
+             y se deshace el reordenamiento
+retorno: -
+*/
+void Dct::inverse(double* x, int stride){
+    for(int k = 0; k < n; ++k) linea[k] = x[(size_t)k * stride];
+    for(int k = 0; k < n; ++k){
+        const double xnk = (k == 0) ? 0.0 : linea[n - k];
+        v[k] = std::conj(giro[k]) * cd(linea[k], -xnk);
+    }
+    dft(v, true);
+    for(int j = 0; 2 * j < n; ++j) x[(size_t)(2 * j) * stride] = v[j].real();
+    for(int j = 0; 2 * j + 1 < n; ++j) x[(size_t)(2 * j + 1) * stride] = v[n - 1 - j].real();
+}
+
+/*
+metodo: transformar
+descripcion: Aplica la DCT (directa o inversa) a lo largo de cada eje de la malla W x H x Dp. Cada hebra usa sus
+             propios planes porque guardan buffers de trabajo
+retorno: -
+*/
+static void transformar(std::vector<double>& a, int W, int H, int Dp, bool inversa){
+    #pragma omp parallel
+    {
+        Dct dx(W);
+        #pragma omp for schedule(static)
+        for(int l = 0; l < H * Dp; ++l){
+            double* base = a.data() + (size_t)l * W;
+            if(inversa) dx.inverse(base, 1); else dx.forward(base, 1);
+        }
+        if(H > 1){
+            Dct dy(H);
+            #pragma omp for schedule(static)
+            for(int l = 0; l < W * Dp; ++l){
+                const int z = l / W, c = l % W;
+                double* base = a.data() + (size_t)z * H * W + c;
+                if(inversa) dy.inverse(base, W); else dy.forward(base, W);
+            }
+        }
+        if(Dp > 1){
+            Dct dz(Dp);
+            #pragma omp for schedule(static)
+            for(int l = 0; l < W * H; ++l){
+                double* base = a.data() + l;
+                if(inversa) dz.inverse(base, W * H); else dz.forward(base, W * H);
+            }
+        }
+    }
+}
+
+/*
+metodo: supports
+descripcion: El avance espectral necesita una malla regular con bordes abiertos y sin nodos eliminados
+retorno: true si se puede usar
+*/
+bool SpectralFastForward::supports(const Network& net){
+    return net.isLattice() && net.getBoundary() == Network::Boundary::Open;
+}
+
+/*
+metodo: advance
+descripcion: Avanza el estado A0 exactamente "steps" pasos del esquema explícito con fuente constante S:
+             a_k(n) = g_k^n a_k(0) + dt s_k (1 - g_k^n) / (1 - g_k), en el espacio de la DCT. Si out_prev no es
+             nulo también se entrega el estado del paso anterior (steps - 1)
+retorno: -
+*/
+void SpectralFastForward::advance(const Network& net, const std::vector<double>& A0, const std::vector<double>& S,
+                                  double dt, long long steps, std::vector<double>& out, std::vector<double>* out_prev){
+    if(!supports(net)){
+        throw std::runtime_error("El avance espectral requiere una malla regular con bordes abiertos");
+    }
+    const int W = net.getAnchoMalla(), H = net.getAltoMalla(), Dp = net.getProfundidadMalla();
+    const double D = net.getDiffusionCoeff();
+    const double gamma = net.getDampingCoeff();
+
+    std::vector<double> a = A0;
+    std::vector<double> s = S;
+    bool con_fuente = false;
+    for(double v : s) if(v != 0.0){ con_fuente = true; break; }
+    transformar(a, W, H, Dp, false);
+    if(con_fuente) transformar(s, W, H, Dp, false);
+
+    //Valores propios del Laplaciano de la cadena abierta: 2 - 2 cos(pi k / n)
+    auto valores = [](int n){
+        std::vector<double> l(n);
+        for(int k = 0; k < n; ++k) l[k] = 2.0 - 2.0 * std::cos(M_PI * k / n);
+        return l;
+    };
+    const std::vector<double> lx = valores(W), ly = valores(H), lz = valores(Dp);
+
+    //Factor de amplificación de n pasos y suma geométrica (1 - g^n)/(1 - g), estable cuando g ~ 1
+    auto factores = [](double h, long long pasos, double& gn, double& geom){
+        const double g = 1.0 - h;
+        if(g > 0.0){
+            const double e = static_cast<double>(pasos) * std::log1p(-h);
+            gn = std::exp(e);
+            geom = (h != 0.0) ? -std::expm1(e) / h : static_cast<double>(pasos);
+        } else {
+            gn = std::pow(g, static_cast<double>(pasos));
+            geom = (1.0 - gn) / h;
+        }
+    };
+
+    out.resize(a.size());
+    if(out_prev) out_prev->resize(a.size());
+    const int N = W * H * Dp;
+    #pragma omp parallel for schedule(static)
+    for(int i = 0; i < N; ++i){
+        const int c = i % W, r = (i / W) % H, z = i / (W * H);
+        const double h = dt * (D * (lx[c] + ly[r] + lz[z]) + gamma);
+        double gn, geom;
+        factores(h, steps, gn, geom);
+        out[i] = gn * a[i] + (con_fuente ? dt * s[i] * geom : 0.0);
+        if(out_prev){
+            factores(h, steps - 1, gn, geom);
+            (*out_prev)[i] = gn * a[i] + (con_fuente ? dt * s[i] * geom : 0.0);
+        }
+    }
+
+    transformar(out, W, H, Dp, true);
+    if(out_prev) transformar(*out_prev, W, H, Dp, true);
+}
@@ -0,0 +1,53 @@
+#ifndef SPECTRALFASTFORWARD_H
+#define SPECTRALFASTFORWARD_H
+
+#include <complex>
+#include <vector>
+
+class Network;
+
+/*
+Abstracción:
+En las mallas regulares con bordes abiertos el Laplaciano se diagonaliza con la transformada coseno (DCT-II):
+cada modo k evoluciona como a_k <- g_k a_k + dt s_k, con g_k = 1 - dt (D lambda_k + gamma). Así se puede avanzar
+el estado cualquier cantidad de pasos en O(N log N), sin recorrer la red paso a paso
+*/
+
+//DCT-II / DCT-III de largo n usando una FFT compleja (radix 2 o Bluestein si n no es potencia de 2)
+class Dct{
+public:
+    //Constructor
+    explicit Dct(int n);
+
+    //otros metodos
+    void forward(double* x, int stride);     // X_k = sum_j x_j cos(pi k (2j+1) / 2n)
+    void inverse(double* x, int stride);     // inversa exacta de forward
+
+private:
+    using cd = std::complex<double>;
+
+    //datos privados
+    int n;
+    int m;                          // largo de la FFT radix 2 (n si es potencia de 2, si no >= 2n-1)
+    bool bluestein;
+    std::vector<cd> giro;           // exp(-i pi k / 2n)
+    std::vector<cd> raices;         // raíces de la unidad para la FFT de largo m
+    std::vector<cd> chirp;          // exp(-i pi j^2 / n)
+    std::vector<cd> chirp_fft;      // FFT del chirp conjugado (núcleo de la convolución de Bluestein)
+    std::vector<cd> v, trabajo;
+    std::vector<double> linea;
+
+    //otros metodos privados
+    void fft(std::vector<cd>& a, bool inversa) const;
+    void dft(std::vector<cd>& a, bool inversa);
+};
+
+class SpectralFastForward{
+public:
+    //otros metodos
+    static bool supports(const Network& net);
+    static void advance(const Network& net, const std::vector<double>& A0, const std::vector<double>& S,
+                        double dt, long long steps, std::vector<double>& out, std::vector<double>* out_prev = nullptr);
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef STATEVIEW_H
+#define STATEVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+Abstracción:
+Vista de solo lectura, sin copia, sobre un buffer de amplitudes (puntero y largo, como std::span), etiquetada con el
+paso y la versión del estado que muestra. La vista apunta al buffer de la red: es válida hasta el siguiente paso
+(los buffers se intercambian en commitStep), lo que se puede comprobar comparando su versión con
+Network::getStateVersion()
+*/
+
+class StateView{
+public:
+    //Constructores
+    StateView() = default;
+    StateView(const double* datos, size_t n, long long paso = 0, uint64_t version = 0)
+        : datos(datos), n(n), paso(paso), version(version) {}
+    StateView(const std::vector<double>& v) : datos(v.data()), n(v.size()) {}
+
+    //getters
+    const double* data() const { return datos; }
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    long long step() const { return paso; }
+    uint64_t getVersion() const { return version; }
+    double operator[](size_t i) const { return datos[i]; }
+    const double* begin() const { return datos; }
+    const double* end() const { return datos + n; }
+
+    //copia explícita, solo para quien necesite conservar el estado más allá del paso
+    std::vector<double> toVector() const { return std::vector<double>(datos, datos + n); }
+
+private:
+    //datos privados
+    const double* datos = nullptr;
+    size_t n = 0;
+    long long paso = 0;
+    uint64_t version = 0;
+};
+
+#endif
@@ -0,0 +1,425 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <omp.h>
+
+#include "SteadyStateSolver.h"
+#include "Network.h"
+
+/*
+metodo: dot
+descripcion: Producto punto paralelo
+retorno: suma de a_i * b_i
+*/
+static double dot(const std::vector<double>& a, const std::vector<double>& b){
+    const int n = static_cast<int>(a.size());
+    double s = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:s)
+    for(int i = 0; i < n; ++i) s += a[i] * b[i];
+    return s;
+}
+
+/*
+Abstracción:
+Precondicionador del gradiente conjugado: z = M^-1 r, con M simétrica definida positiva
+*/
+class SteadyStateSolver::Precondicionador{
+public:
+    virtual ~Precondicionador() = default;
+    virtual void apply(const std::vector<double>& r, std::vector<double>& z) = 0;
+};
+
+/*
+Abstracción:
+Jacobi: divide por la diagonal. Es totalmente paralelo
+*/
+class SteadyStateSolver::PrecJacobi : public SteadyStateSolver::Precondicionador{
+public:
+    explicit PrecJacobi(const MatrizCSR& M) : diag(M.diag) {}
+
+    void apply(const std::vector<double>& r, std::vector<double>& z) override {
+        const int n = static_cast<int>(r.size());
+        #pragma omp parallel for schedule(static)
+        for(int i = 0; i < n; ++i) z[i] = r[i] / diag[i];
+    }
+
+private:
+    const std::vector<double>& diag;
+};
+
+/*
+Abstracción:
+Cholesky incompleto IC(0): L L^T ~ M con el mismo patrón que la parte triangular inferior de M. Converge en
+muchas menos iteraciones que Jacobi, pero las sustituciones triangulares son secuenciales
+*/
+class SteadyStateSolver::PrecIC0 : public SteadyStateSolver::Precondicionador{
+public:
+    explicit PrecIC0(const MatrizCSR& M){
+        n = M.n;
+        fila.assign(n + 1, 0);
+        for(int i = 0; i < n; ++i){
+            for(int k = M.fila[i]; k < M.fila[i+1]; ++k){
+                if(M.col[k] < i){
+                    col.push_back(M.col[k]);
+                    val.push_back(M.val[k]);
+                }
+            }
+            fila[i+1] = static_cast<int>(col.size());
+        }
+        diag.assign(n, 0.0);
+
+        //Factorización por filas: L_ik = (M_ik - sum_j L_ij L_kj) / L_kk, L_ii = sqrt(M_ii - sum_j L_ij^2)
+        for(int i = 0; i < n; ++i){
+            for(int p = fila[i]; p < fila[i+1]; ++p){
+                const int k = col[p];
+                double s = val[p];
+                int a = fila[i], b = fila[k];
+                while(a < p && b < fila[k+1]){
+                    if(col[a] == col[b]) s -= val[a++] * val[b++];
+                    else if(col[a] < col[b]) ++a;
+                    else ++b;
+                }
+                val[p] = s / diag[k];
+            }
+            double d = M.diag[i];
+            for(int p = fila[i]; p < fila[i+1]; ++p) d -= val[p] * val[p];
+            diag[i] = std::sqrt(std::max(d, 1e-12 * M.diag[i]));
+        }
+    }
+
+    void apply(const std::vector<double>& r, std::vector<double>& z) override {
+        //L y = r
+        for(int i = 0; i < n; ++i){
+            double s = r[i];
+            for(int p = fila[i]; p < fila[i+1]; ++p) s -= val[p] * z[col[p]];
+            z[i] = s / diag[i];
+        }
+        //L^T z = y (por columnas, recorriendo las filas de L hacia atrás)
+        for(int i = n - 1; i >= 0; --i){
+            z[i] /= diag[i];
+            for(int p = fila[i]; p < fila[i+1]; ++p) z[col[p]] -= val[p] * z[i];
+        }
+    }
+
+private:
+    int n = 0;
+    std::vector<int> fila;
+    std::vector<int> col;
+    std::vector<double> val;
+    std::vector<double> diag;
+};
+
+/*
+Abstracción:
+V-ciclo multigrid por agregación: cada bloque 2x2x2 de la malla es un nodo del nivel grueso (prolongación
+constante por bloque) y el operador grueso es el de Galerkin P^T M P. Suavizado Jacobi ponderado antes y después,
+así el V-ciclo es simétrico y sirve como precondicionador. El nivel más grueso se resuelve con Cholesky denso
+*/
+class SteadyStateSolver::PrecMultigrid : public SteadyStateSolver::Precondicionador{
+public:
+    static constexpr double kOmega = 2.0 / 3.0;     // peso del suavizador Jacobi
+    static constexpr int kSuavizados = 2;           // barridos antes y después de la corrección gruesa
+
+    PrecMultigrid(const Network& net, const MatrizCSR& M){
+        int W = net.getAnchoMalla(), H = net.getAltoMalla(), Dp = net.getProfundidadMalla();
+        niveles.emplace_back();
+        niveles[0].A = M;
+
+        while(niveles.back().A.n > kTamanoGrueso && (W > 1 || H > 1 || Dp > 1)){
+            const int Wc = (W + 1) / 2, Hc = (H + 1) / 2, Dc = (Dp + 1) / 2;
+            Nivel& fino = niveles.back();
+            fino.agregado.resize(fino.A.n);
+            for(int z = 0; z < Dp; ++z){
+                for(int r = 0; r < H; ++r){
+                    for(int c = 0; c < W; ++c){
+                        fino.agregado[(z*H + r)*W + c] = ((z/2)*Hc + r/2)*Wc + c/2;
+                    }
+                }
+            }
+            Nivel grueso;
+            grueso.A = galerkin(fino.A, fino.agregado, Wc * Hc * Dc);
+            niveles.push_back(std::move(grueso));
+            W = Wc; H = Hc; Dp = Dc;
+        }
+        for(Nivel& nv : niveles){
+            nv.x.assign(nv.A.n, 0.0);
+            nv.b.assign(nv.A.n, 0.0);
+            nv.r.assign(nv.A.n, 0.0);
+        }
+        factorizarGrueso();
+    }
+
+    void apply(const std::vector<double>& r, std::vector<double>& z) override {
+        niveles[0].b = r;
+        vciclo(0);
+        z = niveles[0].x;
+    }
+
+private:
+    struct Nivel{
+        MatrizCSR A;
+        std::vector<int> agregado;      // nodo grueso de cada nodo de este nivel
+        std::vector<double> x, b, r;
+    };
+
+    std::vector<Nivel> niveles;
+    std::vector<double> cholesky;       // factor denso del nivel más grueso (triangular inferior)
+
+    //Operador de Galerkin con prolongación constante por agregado: A_c[I][J] = sum A_ij con i en I, j en J
+    static MatrizCSR galerkin(const MatrizCSR& A, const std::vector<int>& agregado, int nc){
+        std::vector<std::vector<std::pair<int,double>>> filas(nc);
+        for(int i = 0; i < A.n; ++i){
+            const int I = agregado[i];
+            filas[I].push_back({I, A.diag[i]});
+            for(int k = A.fila[i]; k < A.fila[i+1]; ++k) filas[I].push_back({agregado[A.col[k]], A.val[k]});
+        }
+        MatrizCSR C;
+        C.n = nc;
+        C.fila.assign(nc + 1, 0);
+        C.diag.assign(nc, 0.0);
+        for(int I = 0; I < nc; ++I){
+            auto& f = filas[I];
+            std::sort(f.begin(), f.end(), [](const auto& a, const auto& b){ return a.first < b.first; });
+            for(size_t k = 0; k < f.size(); ){
+                const int J = f[k].first;
+                double v = 0.0;
+                while(k < f.size() && f[k].first == J) v += f[k++].second;
+                if(J == I) C.diag[I] = v;
+                else if(v != 0.0){
+                    C.col.push_back(J);
+                    C.val.push_back(v);
+                }
+            }
+            C.fila[I+1] = static_cast<int>(C.col.size());
+            std::vector<std::pair<int,double>>().swap(f);
+        }
+        return C;
+    }
+
+    void factorizarGrueso(){
+        const MatrizCSR& A = niveles.back().A;
+        const int n = A.n;
+        cholesky.assign(static_cast<size_t>(n) * n, 0.0);
+        for(int i = 0; i < n; ++i){
+            cholesky[(size_t)i*n + i] = A.diag[i];
+            for(int k = A.fila[i]; k < A.fila[i+1]; ++k) cholesky[(size_t)i*n + A.col[k]] = A.val[k];
+        }
+        for(int j = 0; j < n; ++j){
+            double d = cholesky[(size_t)j*n + j];
+            for(int k = 0; k < j; ++k) d -= cholesky[(size_t)j*n + k] * cholesky[(size_t)j*n + k];
+            d = std::sqrt(d);
+            cholesky[(size_t)j*n + j] = d;
+            for(int i = j + 1; i < n; ++i){
+                double s = cholesky[(size_t)i*n + j];
+                for(int k = 0; k < j; ++k) s -= cholesky[(size_t)i*n + k] * cholesky[(size_t)j*n + k];
+                cholesky[(size_t)i*n + j] = s / d;
+            }
+        }
+    }
+
+    void resolverGrueso(Nivel& nv){
+        const int n = nv.A.n;
+        for(int i = 0; i < n; ++i){
+            double s = nv.b[i];
+            for(int k = 0; k < i; ++k) s -= cholesky[(size_t)i*n + k] * nv.x[k];
+            nv.x[i] = s / cholesky[(size_t)i*n + i];
+        }
+        for(int i = n - 1; i >= 0; --i){
+            double s = nv.x[i];
+            for(int k = i + 1; k < n; ++k) s -= cholesky[(size_t)k*n + i] * nv.x[k];
+            nv.x[i] = s / cholesky[(size_t)i*n + i];
+        }
+    }
+
+    //x += omega D^-1 (b - A x)
+    static void suavizar(Nivel& nv){
+        multiply(nv.A, nv.x, nv.r);
+        const int n = nv.A.n;
+        #pragma omp parallel for schedule(static)
+        for(int i = 0; i < n; ++i) nv.x[i] += kOmega * (nv.b[i] - nv.r[i]) / nv.A.diag[i];
+    }
+
+    void vciclo(size_t l){
+        Nivel& nv = niveles[l];
+        if(l + 1 == niveles.size()){
+            resolverGrueso(nv);
+            return;
+        }
+        const int n = nv.A.n;
+        std::fill(nv.x.begin(), nv.x.end(), 0.0);
+        for(int s = 0; s < kSuavizados; ++s) suavizar(nv);
+
+        //Restricción del residuo: suma por agregado
+        multiply(nv.A, nv.x, nv.r);
+        Nivel& gr = niveles[l + 1];
+        std::fill(gr.b.begin(), gr.b.end(), 0.0);
+        for(int i = 0; i < n; ++i) gr.b[nv.agregado[i]] += nv.b[i] - nv.r[i];
+
+        vciclo(l + 1);
+
+        //Prolongación constante por agregado
+        #pragma omp parallel for schedule(static)
+        for(int i = 0; i < n; ++i) nv.x[i] += gr.x[nv.agregado[i]];
+
+        for(int s = 0; s < kSuavizados; ++s) suavizar(nv);
+    }
+};
+
+/*
+metodo: buildOperator
+descripcion: Arma la matriz D*L + gamma*I de la red en formato CSR. Las aristas repetidas se suman y los lazos
+             se ignoran (no aportan a la difusión). Los nodos eliminados quedan como filas identidad
+retorno: matriz CSR
+*/
+SteadyStateSolver::MatrizCSR SteadyStateSolver::buildOperator(const Network& net){
+    const int n = net.getSize();
+    const double D = net.getDiffusionCoeff();
+    const double gamma = net.getDampingCoeff();
+
+    MatrizCSR M;
+    M.n = n;
+    M.fila.assign(n + 1, 0);
+    M.diag.assign(n, 0.0);
+
+    std::vector<int> vecinos;
+    for(int i = 0; i < n; ++i){
+        if(net.isRemoved(i)){
+            M.diag[i] = 1.0;
+            M.fila[i+1] = static_cast<int>(M.col.size());
+            continue;
+        }
+        net.getNeighbors(i, vecinos);
+        vecinos.erase(std::remove(vecinos.begin(), vecinos.end(), i), vecinos.end());
+        std::sort(vecinos.begin(), vecinos.end());
+        M.diag[i] = D * static_cast<double>(vecinos.size()) + gamma;
+        for(size_t k = 0; k < vecinos.size(); ){
+            const int j = vecinos[k];
+            double v = 0.0;
+            while(k < vecinos.size() && vecinos[k] == j){ v -= D; ++k; }
+            M.col.push_back(j);
+            M.val.push_back(v);
+        }
+        M.fila[i+1] = static_cast<int>(M.col.size());
+    }
+    return M;
+}
+
+/*
+metodo: multiply
+descripcion: Producto y = M x en paralelo por filas
+retorno: -
+*/
+void SteadyStateSolver::multiply(const MatrizCSR& M, const std::vector<double>& x, std::vector<double>& y){
+    #pragma omp parallel for schedule(static)
+    for(int i = 0; i < M.n; ++i){
+        double s = M.diag[i] * x[i];
+        for(int k = M.fila[i]; k < M.fila[i+1]; ++k) s += M.val[k] * x[M.col[k]];
+        y[i] = s;
+    }
+}
+
+/*
+metodo: makePreconditioner
+descripcion: Crea el precondicionador pedido. El multigrid necesita una malla regular
+retorno: precondicionador
+*/
+std::unique_ptr<SteadyStateSolver::Precondicionador>
+SteadyStateSolver::makePreconditioner(const Network& net, const MatrizCSR& M, Method method){
+    switch(method){
+        case Method::IC0:
+            return std::make_unique<PrecIC0>(M);
+        case Method::Multigrid:
+            if(!net.isLattice()){
+                throw std::runtime_error("El multigrid solo esta disponible para mallas regulares");
+            }
+            return std::make_unique<PrecMultigrid>(net, M);
+        case Method::Jacobi:
+        default:
+            return std::make_unique<PrecJacobi>(M);
+    }
+}
+
+/*
+metodo: solve
+descripcion: Gradiente conjugado precondicionado para (D*L + gamma*I) x = rhs. x entra como valor inicial
+             (por ejemplo el estado actual o la solución de un punto de parámetros vecino) y sale con la solución
+retorno: iteraciones, residuo relativo, convergencia y tiempo
+*/
+SteadyStateSolver::Result SteadyStateSolver::solve(const Network& net, const std::vector<double>& rhs,
+                                                   std::vector<double>& x, Method method,
+                                                   double tol, int max_iter){
+    if(net.getDampingCoeff() <= 0.0){
+        throw std::runtime_error("Sin amortiguamiento (gamma = 0) el sistema estacionario es singular");
+    }
+    const double t0 = omp_get_wtime();
+    const int n = net.getSize();
+    x.resize(n, 0.0);
+
+    const MatrizCSR M = buildOperator(net);
+    std::unique_ptr<Precondicionador> prec = makePreconditioner(net, M, method);
+
+    std::vector<double> r(n), z(n), p(n), q(n);
+    multiply(M, x, q);
+    #pragma omp parallel for schedule(static)
+    for(int i = 0; i < n; ++i) r[i] = rhs[i] - q[i];
+
+    Result res;
+    const double norma_b = std::sqrt(dot(rhs, rhs));
+    const double escala = (norma_b > 0.0) ? norma_b : 1.0;
+    res.residual = std::sqrt(dot(r, r)) / escala;
+
+    prec->apply(r, z);
+    p = z;
+    double rz = dot(r, z);
+
+    while(res.residual > tol && res.iterations < max_iter){
+        multiply(M, p, q);
+        const double alpha = rz / dot(p, q);
+        #pragma omp parallel for schedule(static)
+        for(int i = 0; i < n; ++i){
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+        }
+        ++res.iterations;
+        res.residual = std::sqrt(dot(r, r)) / escala;
+        if(res.residual <= tol) break;
+
+        prec->apply(r, z);
+        const double rz_nuevo = dot(r, z);
+        const double beta = rz_nuevo / rz;
+        rz = rz_nuevo;
+        #pragma omp parallel for schedule(static)
+        for(int i = 0; i < n; ++i) p[i] = z[i] + beta * p[i];
+    }
+
+    res.converged = (res.residual <= tol);
+    res.seconds = omp_get_wtime() - t0;
+    return res;
+}
+
+/*
+metodo: parseMethod
+descripcion: Convierte el nombre del método (jacobi, ic0 o mg) en el enum
+retorno: método
+*/
+SteadyStateSolver::Method SteadyStateSolver::parseMethod(const std::string& name){
+    if(name == "ic0") return Method::IC0;
+    if(name == "mg" || name == "multigrid") return Method::Multigrid;
+    if(name == "jacobi") return Method::Jacobi;
+    throw std::runtime_error("Metodo de resolucion desconocido: " + name);
+}
+
+/*
+metodo: methodName
+descripcion: Nombre del método para los reportes
+retorno: nombre
+*/
+const char* SteadyStateSolver::methodName(Method method){
+    switch(method){
+        case Method::IC0:       return "ic0";
+        case Method::Multigrid: return "mg";
+        case Method::Jacobi:
+        default:                return "jacobi";
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef STEADYSTATESOLVER_H
+#define STEADYSTATESOLVER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class Network;
+
+/*
+Abstracción:
+Resuelve directamente el estado estacionario del modelo, (D*L + gamma*I) A = S, donde L es el Laplaciano del
+grafo. Usa gradiente conjugado precondicionado (paralelo con OpenMP) con precondicionador Jacobi, Cholesky
+incompleto IC(0) o un V-ciclo multigrid por agregación geométrica (bloques 2x2x2) para las mallas regulares
+*/
+
+class SteadyStateSolver{
+public:
+    enum class Method{
+        Jacobi = 0,
+        IC0 = 1,
+        Multigrid = 2
+    };
+
+    //Resultado de una resolución
+    struct Result{
+        int iterations = 0;
+        double residual = 0.0;      // norma relativa ||S - M A|| / ||S||
+        bool converged = false;
+        double seconds = 0.0;
+    };
+
+    //Matriz dispersa simétrica en formato CSR (cada fila ordenada por columna)
+    struct MatrizCSR{
+        int n = 0;
+        std::vector<int> fila;
+        std::vector<int> col;
+        std::vector<double> val;
+        std::vector<double> diag;
+    };
+
+    static constexpr int kTamanoGrueso = 256;     // nivel más grueso del multigrid: Cholesky denso
+
+    //otros metodos
+    static Result solve(const Network& net, const std::vector<double>& rhs, std::vector<double>& x,
+                        Method method, double tol = 1e-10, int max_iter = 10000);
+    static Method parseMethod(const std::string& name);
+    static const char* methodName(Method method);
+
+    static MatrizCSR buildOperator(const Network& net);
+    static void multiply(const MatrizCSR& M, const std::vector<double>& x, std::vector<double>& y);
+
+private:
+    class Precondicionador;
+    class PrecJacobi;
+    class PrecIC0;
+    class PrecMultigrid;
+
+    static std::unique_ptr<Precondicionador> makePreconditioner(const Network& net, const MatrizCSR& M, Method method);
+};
+
+#endif
@@ -0,0 +1,273 @@
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <omp.h>
+
+#include "Telemetry.h"
+#include "FrameRenderer.h"
+
+//Cada hebra toma un fragmento la primera vez que registra algo, por turnos, así hasta kFragmentos hebras
+//escriben sin compartir líneas de caché
+static std::atomic<int> siguiente_fragmento{0};
+
+/*
+metodo: Telemetry
+descripcion: Constructor. Si el destino empieza con "unix:" abre el socket de escucha (si la ruta existe debe ser
+             un socket); luego levanta la hebra exportadora
+retorno: -
+*/
+Telemetry::Telemetry(const std::string& destino, double intervalo)
+    : destino(destino), intervalo(std::max(0.01, intervalo))
+{
+    if(destino.rfind("unix:", 0) == 0){
+        socket_path = destino.substr(5);
+
+        //Solo se reemplaza un socket que haya quedado de una corrida anterior, nunca un archivo de otro tipo
+        struct stat st;
+        if(lstat(socket_path.c_str(), &st) == 0){
+            if(!S_ISSOCK(st.st_mode)) throw std::runtime_error(socket_path + " existe y no es un socket");
+            unlink(socket_path.c_str());
+        }
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(fd < 0) throw std::runtime_error("No se pudo crear el socket de telemetria");
+
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+        if(bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 16) < 0){
+            close(fd);
+            throw std::runtime_error("No se pudo escuchar en " + socket_path);
+        }
+    }
+    t_inicio = t_previo = omp_get_wtime();
+    exportador = std::thread(&Telemetry::loop, this);
+}
+
+/*
+metodo: ~Telemetry
+descripcion: Destructor, detiene la hebra exportadora
+retorno: -
+*/
+Telemetry::~Telemetry(){
+    stop();
+}
+
+/*
+metodo: fragmento
+descripcion: Fragmento de contadores de la hebra que llama
+retorno: referencia al fragmento
+*/
+Telemetry::Fragmento& Telemetry::fragmento(){
+    static thread_local const int k = siguiente_fragmento.fetch_add(1, std::memory_order_relaxed) % kFragmentos;
+    return fragmentos[k];
+}
+
+/*
+metodo: recordStep
+descripcion: Registra un paso de "nodos" nodos que tardó "segundos". Los contadores se suman sin orden entre
+             hebras; el mutex del fragmento solo lo comparte con la hebra exportadora una vez por intervalo
+retorno: -
+*/
+void Telemetry::recordStep(long long nodos, double segundos){
+    Fragmento& f = fragmento();
+    f.pasos.fetch_add(1, std::memory_order_relaxed);
+    f.actualizaciones.fetch_add(static_cast<uint64_t>(nodos), std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(f.mtx);
+    f.tiempos.add(segundos);
+    f.suma_tiempos += segundos;
+}
+
+/*
+metodo: addBytes
+descripcion: Suma bytes escritos a los archivos de salida
+retorno: -
+*/
+void Telemetry::addBytes(long long bytes){
+    if(bytes > 0) fragmento().bytes.fetch_add(static_cast<uint64_t>(bytes), std::memory_order_relaxed);
+}
+
+/*
+metodo: aggregate
+descripcion: Cierra el intervalo: mueve los tiempos de cada fragmento al sketch de la ventana (si el intervalo no
+             tuvo pasos se conserva la anterior) y calcula la tasa de actualizaciones de nodo desde la exportación
+             anterior
+retorno: -
+*/
+void Telemetry::aggregate(){
+    QuantileSketch nueva;
+    double suma = 0.0;
+    uint64_t actualizaciones = 0;
+    for(Fragmento& f : fragmentos){
+        actualizaciones += f.actualizaciones.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(f.mtx);
+        nueva.merge(f.tiempos);
+        f.tiempos.clear();
+        suma += f.suma_tiempos;
+        f.suma_tiempos = 0.0;
+    }
+
+    const double t = omp_get_wtime();
+    std::lock_guard<std::mutex> lock(mtx_agregado);
+    pasos_totales += nueva.count();
+    suma_total += suma;
+    tasa = (t > t_previo) ? static_cast<double>(actualizaciones - actualizaciones_previas) / (t - t_previo) : 0.0;
+    actualizaciones_previas = actualizaciones;
+    t_previo = t;
+    if(nueva.count() > 0) ventana = std::move(nueva);
+}
+
+/*
+metodo: render
+descripcion: Métricas actuales en formato de texto de Prometheus. Los contadores se leen de los fragmentos; la
+             tasa y los percentiles corresponden al último intervalo cerrado
+retorno: string con las métricas
+*/
+std::string Telemetry::render(){
+    uint64_t pasos = 0, actualizaciones = 0, bytes = 0;
+    for(const Fragmento& f : fragmentos){
+        pasos += f.pasos.load(std::memory_order_relaxed);
+        actualizaciones += f.actualizaciones.load(std::memory_order_relaxed);
+        bytes += f.bytes.load(std::memory_order_relaxed);
+    }
+    const size_t profundidad = cola ? cola->queueDepth() : 0;
+
+    std::ostringstream s;
+    auto metrica = [&](const char* nombre, const char* tipo, const char* ayuda){
+        s << "# HELP " << nombre << " " << ayuda << "\n# TYPE " << nombre << " " << tipo << "\n";
+    };
+    metrica("wave_steps_total", "counter", "Pasos completados");
+    s << "wave_steps_total " << pasos << "\n";
+    metrica("wave_node_updates_total", "counter", "Actualizaciones de nodo (nodos x pasos)");
+    s << "wave_node_updates_total " << actualizaciones << "\n";
+    metrica("wave_bytes_written_total", "counter", "Bytes escritos en los archivos de salida");
+    s << "wave_bytes_written_total " << bytes << "\n";
+    metrica("wave_output_queue_depth", "gauge", "Cuadros esperando en la cola de renderizado");
+    s << "wave_output_queue_depth " << profundidad << "\n";
+
+    std::lock_guard<std::mutex> lock(mtx_agregado);
+    metrica("wave_node_updates_per_second", "gauge", "Actualizaciones de nodo por segundo en el ultimo intervalo");
+    s << "wave_node_updates_per_second " << std::setprecision(9) << tasa << "\n";
+    metrica("wave_step_seconds", "summary", "Tiempo por paso (percentiles del ultimo intervalo)");
+    for(double q : kQuantiles){
+        s << "wave_step_seconds{quantile=\"" << q << "\"} ";
+        if(ventana.count() > 0) s << ventana.quantile(q) << "\n";
+        else s << "NaN\n";
+    }
+    s << "wave_step_seconds_sum " << suma_total << "\n";
+    s << "wave_step_seconds_count " << pasos_totales << "\n";
+    metrica("wave_uptime_seconds", "gauge", "Segundos desde que se inicio la telemetria");
+    s << "wave_uptime_seconds " << (omp_get_wtime() - t_inicio) << "\n";
+    return s.str();
+}
+
+/*
+metodo: writeFile
+descripcion: Escribe las métricas en un archivo temporal y lo renombra sobre el destino, así un lector nunca ve
+             un archivo a medio escribir
+retorno: -
+*/
+void Telemetry::writeFile(){
+    const std::string tmp = destino + ".tmp";
+    {
+        std::ofstream f(tmp);
+        if(!f.is_open()) return;
+        f << render();
+    }
+    std::rename(tmp.c_str(), destino.c_str());
+}
+
+/*
+metodo: serve
+descripcion: Responde una conexión al socket. Si el cliente envía una petición HTTP (GET) se antepone la cabecera
+             de respuesta, para que Prometheus o curl --unix-socket puedan leerlo; si no envía nada se responde
+             solo el texto. Si el cliente se desconecta antes se descarta la respuesta (sin SIGPIPE)
+retorno: -
+*/
+void Telemetry::serve(int cli){
+    char peticion[512];
+    ssize_t leidos = 0;
+    pollfd p{cli, POLLIN, 0};
+    if(poll(&p, 1, 100) > 0) leidos = read(cli, peticion, sizeof(peticion));
+
+    std::string resp = render();
+    if(leidos >= 3 && std::strncmp(peticion, "GET", 3) == 0){
+        resp = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+             + std::to_string(resp.size()) + "\r\n\r\n" + resp;
+    }
+    size_t enviados = 0;
+    while(enviados < resp.size()){
+        const ssize_t n = send(cli, resp.data() + enviados, resp.size() - enviados, MSG_NOSIGNAL);
+        if(n <= 0) break;
+        enviados += static_cast<size_t>(n);
+    }
+    close(cli);
+}
+
+/*
+metodo: loop
+descripcion: Hebra exportadora: cada intervalo agrega los fragmentos y reescribe el archivo; con socket atiende
+             las conexiones mientras espera el siguiente intervalo
+retorno: -
+*/
+void Telemetry::loop(){
+    double proximo = omp_get_wtime() + intervalo;
+    for(;;){
+        if(fd >= 0){
+            const int espera = std::max(0, std::min(100, static_cast<int>((proximo - omp_get_wtime()) * 1e3)));
+            pollfd p{fd, POLLIN, 0};
+            if(poll(&p, 1, espera) > 0){
+                const int cli = accept(fd, nullptr, nullptr);
+                if(cli >= 0) serve(cli);
+            }
+            std::lock_guard<std::mutex> lock(mtx_parada);
+            if(terminar) break;
+        } else {
+            std::unique_lock<std::mutex> lock(mtx_parada);
+            const double resto = std::max(0.0, proximo - omp_get_wtime());
+            if(cv.wait_for(lock, std::chrono::duration<double>(resto), [&]{ return terminar; })) break;
+        }
+        if(omp_get_wtime() >= proximo){
+            aggregate();
+            if(fd < 0) writeFile();
+            proximo += intervalo;
+        }
+    }
+}
+
+/*
+metodo: stop
+descripcion: Detiene la hebra exportadora y deja el estado final: el archivo se escribe una última vez y el socket
+             se cierra y se elimina
+retorno: -
+*/
+void Telemetry::stop(){
+    {
+        std::lock_guard<std::mutex> lock(mtx_parada);
+        if(terminar) return;
+        terminar = true;
+    }
+    cv.notify_all();
+    if(exportador.joinable()) exportador.join();
+
+    aggregate();
+    if(fd >= 0){
+        close(fd);
+        unlink(socket_path.c_str());
+        fd = -1;
+    } else {
+        writeFile();
+    }
+}
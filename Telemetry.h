@@ -0,0 +1,87 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "DistributionMetrics.h"
+
+class FrameRenderer;
+
+/*
+Abstracción:
+Telemetría en vivo de una simulación larga: pasos completados, actualizaciones de nodo (y su tasa), bytes escritos,
+largo de la cola de salida y percentiles del tiempo por paso. Los contadores están repartidos en fragmentos de una
+línea de caché cada uno; cada hebra escribe en el suyo sin contención y una hebra auxiliar los suma cada cierto
+intervalo y exporta el resultado en formato de texto de Prometheus, a un archivo (reemplazado atómicamente, como lo
+lee el textfile collector de node_exporter) o a un socket Unix ("unix:<ruta>") que responde con las métricas a cada
+conexión
+*/
+
+class Telemetry{
+public:
+    static constexpr int kFragmentos = 16;
+    static constexpr double kQuantiles[] = {0.5, 0.9, 0.99};
+
+    //Constructor: destino (archivo o "unix:<ruta>") e intervalo de exportación en segundos
+    Telemetry(const std::string& destino, double intervalo = 1.0);
+    ~Telemetry();
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    //setters
+    void setQueue(FrameRenderer* renderer) { cola = renderer; }    // no toma posesión
+
+    //otros metodos
+    void recordStep(long long nodos, double segundos);
+    void addBytes(long long bytes);
+    std::string render();
+    void stop();
+
+private:
+    //Fragmento de contadores de un grupo de hebras; el sketch de tiempos guarda solo el intervalo en curso
+    struct alignas(64) Fragmento{
+        std::atomic<uint64_t> pasos{0};
+        std::atomic<uint64_t> actualizaciones{0};
+        std::atomic<uint64_t> bytes{0};
+        std::mutex mtx;
+        QuantileSketch tiempos;
+        double suma_tiempos = 0.0;
+    };
+
+    //datos privados
+    std::string destino;
+    std::string socket_path;            // vacío si se exporta a archivo
+    double intervalo;
+    FrameRenderer* cola = nullptr;
+    Fragmento fragmentos[kFragmentos];
+
+    //Estado agregado por la hebra exportadora en cada intervalo
+    std::mutex mtx_agregado;
+    QuantileSketch ventana;             // tiempos por paso del último intervalo con pasos
+    uint64_t pasos_totales = 0;
+    uint64_t actualizaciones_previas = 0;
+    double suma_total = 0.0;
+    double tasa = 0.0;                  // actualizaciones de nodo por segundo en el último intervalo
+    double t_inicio = 0.0;
+    double t_previo = 0.0;
+
+    int fd = -1;
+    std::mutex mtx_parada;
+    std::condition_variable cv;
+    bool terminar = false;
+    std::thread exportador;
+
+    //otros metodos privados
+    Fragmento& fragmento();
+    void aggregate();
+    void writeFile();
+    void serve(int cli);
+    void loop();
+};
+
+#endif
@@ -4,6 +4,8 @@
 
 #include "WavePropagation.h"
 #include "Network.h"
+#include "MetricsCalculator.h"
+#include "ExecutionPolicy.h"
 
 /*
 metodo: WavePropagator
@@ -28,10 +30,9 @@ descripcion: calculo de energia para el caso lineal
 retorno: -
 */
 void WavePropagator::calculateEnergy(){
-    const std::vector<Node>& nodes = network->getNodes();
+    const StateView amplitudes = network->getStateView();
     this->energy = 0.0;
-    for(const Node& node : nodes){
-        double amp = node.getAmplitude();
+    for(double amp : amplitudes){
         energy += amp * amp;
     }
 }
@@ -43,24 +44,27 @@ retorno: -
 */
 //Ahora lo vamos a realizar, pero con un metodo
 void WavePropagator::calculateEnergy(int method){
-    const std::vector<Node>& nodes = network->getNodes();
+    const StateView amplitudes = network->getStateView();
+    const int hebras = ExecutionPolicy::threadsFor(static_cast<long long>(amplitudes.size()));
     this->energy = 0.0;
 
     if(method == 0){
-        #pragma omp parallel for reduction(+:energy) 
-        for(const Node& node : nodes){
-            double amp = node.getAmplitude();
+        #pragma omp parallel for reduction(+:energy) if(hebras > 1) num_threads(hebras)
+        for(double amp : amplitudes){
             energy += amp * amp;
         }
     }
     else if(method == 1){
-        #pragma omp parallel for 
-        for(const Node& node : nodes){
-            double amp = node.getAmplitude();
+        #pragma omp parallel for if(hebras > 1) num_threads(hebras)
+        for(double amp : amplitudes){
             #pragma omp atomic 
             energy += amp * amp;
         }
     }
+    else if(method == 2){
+        //Reducción de forma fija: mismos bits para cualquier cantidad de hebras
+        energy = MetricsCalculator::CalcularEnergiaReproducible(amplitudes);
+    }
 }
 
 /*
@@ -69,35 +73,34 @@ descripcion:
 retorno: -
 */
 void WavePropagator::calculateEnergy(int method, bool use_private){
-    const std::vector<Node>& nodes = network->getNodes();
+    const StateView amplitudes = network->getStateView();
+    const int hebras = ExecutionPolicy::threadsFor(static_cast<long long>(amplitudes.size()));
     this->energy = 0.0;
 
     if(method == 0){
         if(use_private){
-            #pragma omp parallel
+            #pragma omp parallel if(hebras > 1) num_threads(hebras)
             {
                 double local_energy = 0.0;
                 #pragma omp for nowait
-                for(const Node& node : nodes){
-                    double amp = node.getAmplitude();
+                for(double amp : amplitudes){
                     local_energy += amp * amp;
                 }
                 #pragma omp atomic
                 this->energy += local_energy;
             } 
         }else {
-            #pragma omp parallel for reduction(+:energy)
-            for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
-                double amp = nodes[i].getAmplitude();
+            #pragma omp parallel for reduction(+:energy) if(hebras > 1) num_threads(hebras)
+            for (int i = 0; i < static_cast<int>(amplitudes.size()); ++i) {
+                double amp = amplitudes[i];
                 energy += amp * amp;
             }
 
         }
     }
     else if(method == 1){
-        #pragma omp parallel for 
-        for(const Node& node : nodes){
-            double amp = node.getAmplitude();
+        #pragma omp parallel for if(hebras > 1) num_threads(hebras)
+        for(double amp : amplitudes){
             #pragma omp atomic
             energy += amp * amp;
         }
@@ -110,12 +113,12 @@ descripcion:
 retorno: -
 */
 void WavePropagator::processNodes(){
-    const std::vector<Node>& nodes = network->getNodes();
+    const StateView amplitudes = network->getStateView();
 
     //Vamos a sumar la amplitud de los nodos
     double sum = 0.0;
-    for(int i = 0; i < static_cast<int>(nodes.size()); ++i){
-        sum += nodes[i].getAmplitude();
+    for(int i = 0; i < static_cast<int>(amplitudes.size()); ++i){
+        sum += amplitudes[i];
     }
     std::cout << "La suma de las amplitudes es: " << sum << std::endl;
 }
@@ -131,7 +134,7 @@ void WavePropagator::processNodes(int task_type){
     if (task_type == 0) {
 
         //Conseguimos los vectores
-        std::vector<Node>& nodes = network->getNodes();
+        std::vector<double>& amplitudes = network->getAmplitudes();
         double sum = 0.0;
 
         //Comienza la paralelización
@@ -141,10 +144,10 @@ void WavePropagator::processNodes(int task_type){
             //Se aplica omp single
             #pragma omp single
             {
-                for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
-                    #pragma omp task shared(nodes, sum)
+                for (int i = 0; i < static_cast<int>(amplitudes.size()); ++i) {
+                    #pragma omp task shared(amplitudes, sum)
                     {
-                        double local_sum = nodes[i].getAmplitude();
+                        double local_sum = amplitudes[i];
                         #pragma omp atomic
                         sum += local_sum;
                     }
@@ -154,11 +157,11 @@ void WavePropagator::processNodes(int task_type){
         std::cout << "Suma de amplitudes (tasks): " << sum << std::endl;
     } else if (task_type == 1) {
         // Usar parallel for
-        std::vector<Node>& nodes = network->getNodes();
+        std::vector<double>& amplitudes = network->getAmplitudes();
         double sum = 0.0;
         #pragma omp parallel for reduction(+:sum)
-        for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
-            sum += nodes[i].getAmplitude();
+        for (int i = 0; i < static_cast<int>(amplitudes.size()); ++i) {
+            sum += amplitudes[i];
         }
         std::cout << "Suma de amplitudes (parallel for): " << sum << std::endl;
     }
@@ -172,7 +175,7 @@ retorno: -
 void WavePropagator::processNodes(int task_type, bool use_single){
     if(use_single){
         //Lo usamos para imprimir
-        std::vector<Node>& nodes = network->getNodes();
+        std::vector<double>& amplitudes = network->getAmplitudes();
         double sum = 0.0;
         if(task_type){
 
@@ -181,10 +184,10 @@ void WavePropagator::processNodes(int task_type, bool use_single){
             {
                 #pragma omp single
                 {
-                    for(int i = 0; i < static_cast<int>(nodes.size()); ++i){
-                        #pragma omp task shared(nodes, sum)
+                    for(int i = 0; i < static_cast<int>(amplitudes.size()); ++i){
+                        #pragma omp task shared(amplitudes, sum)
                         {
-                            double local_sum = nodes[i].getAmplitude();
+                            double local_sum = amplitudes[i];
                             #pragma omp atomic
                             sum += local_sum;
                         }
@@ -194,8 +197,8 @@ void WavePropagator::processNodes(int task_type, bool use_single){
         } else{
             //Hacemos un parallel for con single solamente
             #pragma omp parallel for reduction(+:sum)
-            for(int i = 0; i < static_cast<int>(nodes.size()); ++i){
-                sum += nodes[i].getAmplitude();
+            for(int i = 0; i < static_cast<int>(amplitudes.size()); ++i){
+                sum += amplitudes[i];
             }
         }
     } else{
@@ -212,15 +215,15 @@ descripcion:
 retorno: -
 */
 void WavePropagator::simulatePhasesBarrier(){
-    std::vector<Node>& nodes = network->getNodes();
-    std::vector<double> temp(nodes.size(), 0.0);
+    std::vector<double>& amplitudes = network->getAmplitudes();
+    std::vector<double> temp(amplitudes.size(), 0.0);
 
     #pragma omp parallel
     {
         //Vamos a hacer algún for
         #pragma omp for
-        for(int i = 0; i < static_cast<int>(nodes.size()); i++){
-            temp[i] = nodes[i].getAmplitude() * 2;
+        for(int i = 0; i < static_cast<int>(amplitudes.size()); i++){
+            temp[i] = amplitudes[i] * 2;
         }
 
         //Colocamos la barrera
@@ -228,8 +231,8 @@ void WavePropagator::simulatePhasesBarrier(){
 
         //Vamos a hacer el segundo for
         #pragma omp for
-        for(int i = 0; i < static_cast<int>(nodes.size()); i++){
-            nodes[i].setAmplitude(temp[i]);
+        for(int i = 0; i < static_cast<int>(amplitudes.size()); i++){
+            amplitudes[i] = temp[i];
         }
     }
 
@@ -241,7 +244,7 @@ descripcion:
 retorno: -
 */
 void WavePropagator::parallelInitializationSingle() {
-    std::vector<Node>& nodes = network->getNodes();
+    std::vector<double>& amplitudes = network->getAmplitudes();
 
     #pragma omp parallel
     {
@@ -249,8 +252,8 @@ void WavePropagator::parallelInitializationSingle() {
         #pragma omp single
         {
             std::cout << "Soy la hebra, " << tid << " inicializando las hebras." << std::endl;
-            for (Node& node : nodes) {
-                node.setAmplitude(0.0);
+            for (double& amp : amplitudes) {
+                amp = 0.0;
             }
         }
     }
@@ -262,12 +265,12 @@ descripcion:
 retorno: -
 */
 void WavePropagator::calculateMetricsFirstprivate() {
-    std::vector<Node>& nodes = network->getNodes();
+    std::vector<double>& amplitudes = network->getAmplitudes();
     double offset = 10.0; // Ejemplo: cada hilo parte de este valor
 
     #pragma omp parallel for firstprivate(offset)
-    for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
-        [[maybe_unused]] double value = offset + nodes[i].getAmplitude();
+    for (int i = 0; i < static_cast<int>(amplitudes.size()); ++i) {
+        [[maybe_unused]] double value = offset + amplitudes[i];
         // Puedes hacer lo que quieras con value, ej: imprimirlo
         // Aquí solo para demostrar el uso de firstprivate
         #pragma omp critical
@@ -283,12 +286,12 @@ descripcion:
 retorno: -
 */
 void WavePropagator::calculateFinalStateLastprivate() {
-    std::vector<Node>& nodes = network->getNodes();
+    std::vector<double>& amplitudes = network->getAmplitudes();
     double last_amplitude = 0.0;
 
     #pragma omp parallel for lastprivate(last_amplitude)
-    for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
-        last_amplitude = nodes[i].getAmplitude();
+    for (int i = 0; i < static_cast<int>(amplitudes.size()); ++i) {
+        last_amplitude = amplitudes[i];
     }
     std::cout << "[lastprivate] Última amplitud procesada: " << last_amplitude << std::endl;
 }
\ No newline at end of file
@@ -24,7 +24,7 @@ class WavePropagator {
         //Otros metodos 
         // Funcion overloading para calculo de energia
         void calculateEnergy(); // Calculo basico
-        void calculateEnergy(int method); // reduce=0, atomic=1
+        void calculateEnergy(int method); // reduce=0, atomic=1, reproducible=2
         void calculateEnergy(int method, bool use_private);
 
         // Funcion overloading para procesamiento de nodos
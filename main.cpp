@@ -7,37 +7,290 @@
 #include <cmath>
 #include <algorithm>
 #include <filesystem>
+#include <memory>
+#include <cctype>
+#include <stdexcept>
 
 #include "WavePropagation.h"
 #include "Benchmark.h"
 #include "MetricsCalculator.h"
 #include "FileManagement.h"
+#include "Autotuner.h"
+#include "SimulationServer.h"
+#include "ParameterSweep.h"
+#include "OutOfCore.h"
+#include "SpectralAnalyzer.h"
+#include "ArrivalTracker.h"
+#include "DistributionMetrics.h"
+#include "ExecutionPolicy.h"
+#include "FrameRenderer.h"
+#include "SnapshotRing.h"
+#include "ForcingStream.h"
+#include "Telemetry.h"
 
 #include <omp.h>
 
+/*
+metodo: flagValue
+descripcion: Busca una flag en los argumentos y devuelve el argumento que la sigue
+retorno: puntero al valor o nullptr si la flag no existe
+*/
+static const char* flagValue(int argc, char** argv, const std::string& flag, int offset = 1){
+    for(int i = 1; i + offset < argc; ++i){
+        if(flag == argv[i]) return argv[i + offset];
+    }
+    return nullptr;
+}
+
+/*
+metodo: hasFlag
+descripcion: Indica si una flag aparece en los argumentos
+retorno: booleano
+*/
+static bool hasFlag(int argc, char** argv, const std::string& flag){
+    for(int i = 1; i < argc; ++i){
+        if(flag == argv[i]) return true;
+    }
+    return false;
+}
+
+/*
+metodo: isNumber
+descripcion: Indica si un argumento es un entero (para los parametros posicionales schedule y chunk)
+retorno: booleano
+*/
+static bool isNumber(const char* s){
+    if(!s || !*s) return false;
+    for(const char* c = s; *c; ++c){
+        if(!std::isdigit(static_cast<unsigned char>(*c))) return false;
+    }
+    return true;
+}
+
+/*
+metodo: checkGrowingNetwork
+descripcion: Verificación de agregar nodos con un seguimiento de llegadas y un forzamiento desde archivo activos:
+             malla 1D con pulso, lectura de vecinos sin convertir la malla, dos nodos nuevos conectados al extremo
+             y más pasos. El seguimiento debe crecer con la red, los nodos nuevos (sin columna de forzamiento) deben
+             recibir la onda y getNode queda disponible una vez que la malla se convirtió
+retorno: 0 si todo está bien, 1 si no
+*/
+static int checkGrowingNetwork(){
+    const int N = 64;
+    const std::string forzamiento = "datos/check forcing.bin";
+    FileManagement::crearCarpeta();
+    ForcingStream::writeSine(forzamiento, N, 40, 0.01, 0.05, 2.0 * M_PI);
+
+    int errores = 0;
+    {
+        ForcingStream stream(forzamiento);
+        ArrivalTracker tracker(N, {1e-6, 1e-3});
+        Network red(N, 0.5, 0.01);
+        red.initializeRegularNetwork(1, N, 1, 1, Network::Boundary::Open);
+        red.setTimeStep(0.01);
+        red.setStreamedSource(&stream);
+        red.setArrivalTracker(&tracker);
+        red.setAmplitude(N - 1, 1.0);
+        for(int step = 1; step <= 5; ++step) red.propagateWaves(0);
+
+        //Leer la malla no la convierte a topología explícita; getNode no aplica hasta la primera modificación
+        std::vector<int> vecinos;
+        red.getNeighbors(N - 1, vecinos);
+        if(red.getDegree(N - 1) != 1 || vecinos != std::vector<int>{N - 2} || !red.isLattice()) ++errores;
+        const int a = red.addNode(0.0);
+        const int b = red.addNode(0.0);
+        red.addEdge(N - 1, a);
+        red.addEdge(a, b);
+        for(int step = 6; step <= 30; ++step) red.propagateWaves(0);
+
+        if(tracker.getSize() != N + 2) ++errores;
+        if(red.isLattice() || red.getNode(N - 1).getDegree() != 2) ++errores;
+        if(tracker.arrivalStep(a, 0) < 6 || tracker.arrivalStep(b, 0) < 6) ++errores;
+        for(double v : red.getAmplitudes()) if(!std::isfinite(v)) ++errores;
+        red.setArrivalTracker(nullptr);
+        red.setStreamedSource(nullptr);
+    }
+    std::filesystem::remove(forzamiento);
+
+    std::cout << "Verificacion de addNode con seguimiento y forzamiento: " << (errores == 0 ? "ok" : "ERROR") << std::endl;
+    return errores == 0 ? 0 : 1;
+}
+
 int main(int argc, char** argv) {
     if (argc >= 2 && std::string(argv[1]) == "-benchmark"){
-        return Benchmark::runBenchmark();
+        const char* baseline = flagValue(argc, argv, "-compare");
+        return Benchmark::runBenchmark(baseline ? baseline : "");
     }
 
-    //Vamos a definir el schedule_type y el chunk_size como valores de entrada
-    int schedule_type = 0;
-    int chunk_size = 0;
-    bool use_collapse = false;
+    //Modo servidor: recibe trabajos por un socket Unix local (por defecto /tmp/wave_propagation.sock)
+    if (argc >= 2 && std::string(argv[1]) == "-server"){
+        SimulationServer server(argc >= 3 ? argv[2] : "/tmp/wave_propagation.sock");
+        return server.run();
+    }
 
-    //Conseguimos valores dependiendo del valor de argc
-    if(argc >= 2) schedule_type = std::stoi(argv[1]);
-    if(argc >= 3) chunk_size = std::stoi(argv[2]);
+    //Telemetría en vivo en formato Prometheus: -telemetry <archivo|unix:ruta> [-telemetry-every <segundos>]
+    const char* telemetry_arg = flagValue(argc, argv, "-telemetry");
+    const char* telemetry_every_arg = flagValue(argc, argv, "-telemetry-every");
+    std::unique_ptr<Telemetry> telemetry;
+    if(telemetry_arg){
+        try {
+            telemetry = std::make_unique<Telemetry>(telemetry_arg,
+                                                    telemetry_every_arg ? std::stod(telemetry_every_arg) : 1.0);
+        } catch(const std::exception& e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
 
-    //Si se quiere hacer un red 2D se puede agregar la flag -collapse
-    if(argc >= 4 && std::string(argv[3]) == "-collapse") use_collapse = true;
+    //Barrido de parametros en un solo proceso: -sweep <archivo> (una linea clave=valor por punto)
+    if (argc >= 3 && std::string(argv[1]) == "-sweep"){
+        return ParameterSweep::runSweep(argv[2], "datos/sweep results.dat", telemetry.get());
+    }
 
-    //Inicializamos los parametros con los que vamos a trabajar
+    //Lector de ejemplo del anillo en memoria compartida: -shm-monitor <nombre>
+    if (argc >= 3 && std::string(argv[1]) == "-shm-monitor"){
+        return SnapshotRing::runMonitor(argv[2]);
+    }
+
+    //Barrido de tamaños (L1/L2/L3/DRAM), escalamiento débil y roofline
+    if (argc >= 2 && std::string(argv[1]) == "-roofline"){
+        return Benchmark::runMemorySweep();
+    }
+
+    //Verificación de redes que crecen durante la simulación (addNode con seguimiento y forzamiento activos)
+    if (argc >= 2 && std::string(argv[1]) == "-check-topology"){
+        return checkGrowingNetwork();
+    }
+
+    //Comparación de dos archivos de resultados ya existentes: -compare <linea base> <nuevo>
+    if (argc >= 4 && std::string(argv[1]) == "-compare"){
+        auto base = Benchmark::loadDat(argv[2]);
+        auto nuevo = Benchmark::loadDat(argv[3]);
+        if(base.empty() || nuevo.empty()) return 1;
+        FileManagement::crearCarpeta();
+        return (Benchmark::compareResults(base, nuevo, "datos/regression report.dat") > 0) ? 1 : 0;
+    }
+
+    //Topología de la red: 1 para 1D, 2 para 2D y 3 para 3D (ancho x alto x profundidad debe ser igual a num_nodes)
+    const int dimensions = 1;
+    const int grid_w = 10;
+    const int grid_h = 10;
+    const int grid_d = 1;
+    const bool periodic = false;   // true para bordes periódicos (toro)
     const int num_nodes = 100;
+    const Network::Boundary boundary = periodic ? Network::Boundary::Periodic : Network::Boundary::Open;
+
+    //Inicializamos los parametros con los que vamos a trabajar
     const double D = 6;
     const double gamma = 0.01;
     const double dt = 0.01;
     const int num_steps = 1000;
+
+    //Escribe la topología de esta red en formato CSR binario para el modo out-of-core
+    if (argc >= 3 && std::string(argv[1]) == "-export-topology"){
+        Network red(num_nodes, D, gamma);
+        red.initializeRegularNetwork(dimensions, grid_w, grid_h, grid_d, boundary);
+        OutOfCoreNetwork::writeTopology(red, argv[2]);
+        std::cout << "Topologia escrita en " << argv[2] << std::endl;
+        return 0;
+    }
+
+    //Modo out-of-core: -outofcore <topologia> [pasos] [fuente uniforme]
+    if (argc >= 3 && std::string(argv[1]) == "-outofcore"){
+        const int pasos = (argc >= 4) ? std::stoi(argv[3]) : num_steps;
+        const double fuente = (argc >= 5) ? std::stod(argv[4]) : 0.0;
+        return OutOfCoreNetwork::runOutOfCore(argv[2], D, gamma, dt, pasos, fuente);
+    }
+
+    //Genera un archivo de forzamiento de ejemplo (onda viajera senoidal): -make-forcing <archivo>
+    if (argc >= 3 && std::string(argv[1]) == "-make-forcing"){
+        ForcingStream::writeSine(argv[2], num_nodes, num_steps, dt, 0.05, 2.0 * M_PI);
+        std::cout << "Forzamiento escrito en " << argv[2] << std::endl;
+        return 0;
+    }
+
+    //Busca la mejor configuración para esta topología y la guarda en datos/tuning.db
+    if (argc >= 2 && std::string(argv[1]) == "-autotune"){
+        return Autotuner::runAutotune(dimensions, num_nodes, grid_w, grid_h, grid_d, periodic);
+    }
+
+    //Vamos a definir el schedule_type y el chunk_size como valores de entrada
+    int schedule_type = 0;
+    int chunk_size = 0;
+    bool use_collapse = false;
+
+    //Conseguimos valores de los parametros posicionales (los primeros argumentos numéricos)
+    const bool schedule_given = (argc >= 2 && isNumber(argv[1]));
+    if(schedule_given) schedule_type = std::stoi(argv[1]);
+    if(schedule_given && argc >= 3 && isNumber(argv[2])) chunk_size = std::stoi(argv[2]);
+
+    //Si se quiere hacer un red 2D se puede agregar la flag -collapse
+    if(hasFlag(argc, argv, "-collapse")) use_collapse = true;
+
+    //Análisis espectral in situ: -spectrum f1,f2,... (Hz). Reemplaza la escritura de la evolución completa
+    const char* spectrum_arg = flagValue(argc, argv, "-spectrum");
+
+    //Tiempos de llegada in situ: -arrival u1,u2,... (umbrales de |amplitud|). También reemplaza la evolución completa
+    const char* arrival_arg = flagValue(argc, argv, "-arrival");
+
+    //Métricas de distribución cada n pasos: -distribution <n> [-dist-bins B] [-dist-range lo,hi] [-dist-quantiles q1,...]
+    const char* dist_arg = flagValue(argc, argv, "-distribution");
+    const int dist_every = dist_arg ? std::max(1, std::stoi(dist_arg)) : 0;
+    const bool write_frames = (spectrum_arg == nullptr && arrival_arg == nullptr && dist_arg == nullptr);
+
+    //Renderizado de cuadros PNG en segundo plano: -render <cada_n_pasos>
+    const char* render_arg = flagValue(argc, argv, "-render");
+    const int render_every = render_arg ? std::max(1, std::stoi(render_arg)) : 0;
+
+    //Publicación del estado en memoria compartida: -shm <nombre> [-shm-every <n>]
+    const char* shm_arg = flagValue(argc, argv, "-shm");
+    const char* shm_every_arg = flagValue(argc, argv, "-shm-every");
+    const int shm_every = shm_every_arg ? std::max(1, std::stoi(shm_every_arg)) : 1;
+
+    //Detección de estado estacionario: -steady <tolerancia> termina cuando el cambio máximo por paso baja de ella
+    const char* steady_arg = flagValue(argc, argv, "-steady");
+    const double steady_tol = steady_arg ? std::stod(steady_arg) : 0.0;
+
+    //Resolución directa del estado estacionario: -solve <jacobi|ic0|mg>
+    const char* solve_arg = flagValue(argc, argv, "-solve");
+
+    //Avance espectral: -fast-forward <pasos> salta directamente al estado de ese paso
+    const char* fast_forward_arg = flagValue(argc, argv, "-fast-forward");
+
+    //Forzamiento por nodo leído paso a paso desde archivo: -forcing <archivo>
+    const char* forcing_arg = flagValue(argc, argv, "-forcing");
+
+    //Si no se entregan parametros se usa la configuración autotuneada (si existe)
+    bool tuned_applied = false;
+    if(!schedule_given){
+        TuningConfig tuned;
+        if(Autotuner::lookup(Autotuner::kTuningPath,
+                             Autotuner::makeKey(dimensions, num_nodes, grid_w, grid_h, grid_d, periodic),
+                             Autotuner::machineFingerprint(), tuned)){
+            schedule_type = tuned.getSchedule();
+            chunk_size = tuned.getChunk();
+            use_collapse = (tuned.getVariant() == 1);
+            omp_set_num_threads(tuned.getThreads());
+            tuned_applied = true;
+            std::cout << "Usando configuracion autotuneada: schedule=" << schedule_type
+                      << " chunk=" << chunk_size << " threads=" << tuned.getThreads()
+                      << (use_collapse ? " collapse" : "") << std::endl;
+        }
+    }
+
+    //Política de ejecución por kernel: -exec auto|serial|parallel (auto elige serie para redes pequeñas)
+    const char* exec_arg = flagValue(argc, argv, "-exec");
+    //La configuración autotuneada se midió en modo parallel: se reproduce igual, salvo que se pida otro modo
+    if(exec_arg){
+        try {
+            ExecutionPolicy::setMode(ExecutionPolicy::parseMode(exec_arg));
+        } catch(const std::exception& e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    else if(tuned_applied) ExecutionPolicy::setMode(ExecutionPolicy::Mode::Parallel);
+
     double energy = 0.0;
     
     std::cout << "Parametros: \n- Nodos=" << num_nodes << ", \n- D=" << D << ", \n- gamma=" << gamma;
@@ -46,15 +299,78 @@ int main(int argc, char** argv) {
     //Se crea una red que se llamara "my_network"
     Network myNetwork(num_nodes, D, gamma);
 
-    //Creamos un red. 1 para 1D y 2 para 2D
-    myNetwork.initializeRegularNetwork(1);
-    //myNetwork.initializeRegularNetwork(2, 10, 10);
+    //Creamos un red. 1 para 1D, 2 para 2D y 3 para 3D
+    myNetwork.initializeRegularNetwork(dimensions, grid_w, grid_h, grid_d, boundary);
     myNetwork.setTimeStep(dt);
 
+    const Network::MemoryFootprint memoria = myNetwork.getMemoryFootprint();
+    std::cout << "- Memoria=" << memoria.total() << " bytes (" << memoria.bytesPerNode() << " B/nodo)" << std::endl;
+    std::cout << "- Ejecucion=" << ExecutionPolicy::describe(num_nodes) << std::endl;
+
     FileManagement::configureExternalSource(myNetwork, num_nodes);
 
+    std::unique_ptr<ForcingStream> forcing;
+    if(forcing_arg){
+        try {
+            forcing = std::make_unique<ForcingStream>(forcing_arg);
+            myNetwork.setStreamedSource(forcing.get());
+        } catch(const std::exception& e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if(solve_arg){
+        SteadyStateSolver::Method metodo = SteadyStateSolver::Method::Jacobi;
+        SteadyStateSolver::Result res;
+        try {
+            metodo = SteadyStateSolver::parseMethod(solve_arg);
+            res = myNetwork.solveSteadyState(metodo);
+        } catch(const std::exception& e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Estado estacionario (" << SteadyStateSolver::methodName(metodo) << "): "
+                  << res.iterations << " iteraciones, residuo " << res.residual
+                  << ", " << res.seconds << "s" << (res.converged ? "" : " (sin converger)") << std::endl;
+        FileManagement::crearCarpeta();
+        FileManagement::writeSteadySolution("datos/steady solution.dat", myNetwork, res);
+        return res.converged ? 0 : 1;
+    }
+
     //Vamos a definir la pertubación inicial para que la señal se mueva
-    myNetwork.getNode(num_nodes/2).setAmplitude(1.0);
+    myNetwork.setAmplitude(num_nodes/2, 1.0);
+
+    if(fast_forward_arg){
+        long long pasos = 0;
+        Network referencia = myNetwork;
+        double t_ff = omp_get_wtime();
+        try {
+            if(!isNumber(fast_forward_arg)){
+                throw std::runtime_error(std::string("-fast-forward espera un numero de pasos: ") + fast_forward_arg);
+            }
+            pasos = std::stoll(fast_forward_arg);
+            myNetwork.fastForward(pasos);
+        } catch(const std::exception& e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        t_ff = omp_get_wtime() - t_ff;
+        std::cout << "Avance espectral de " << pasos << " pasos en " << t_ff << "s" << std::endl;
+
+        //Con pocos pasos se compara contra la integración paso a paso
+        if(pasos <= num_steps){
+            for(long long k = 0; k < pasos; ++k) referencia.propagateWaves(schedule_type);
+            double diff = 0.0;
+            for(int i = 0; i < num_nodes; ++i){
+                diff = std::max(diff, std::fabs(referencia.getAmplitude(i) - myNetwork.getAmplitude(i)));
+            }
+            std::cout << "Diferencia maxima con la integracion paso a paso: " << diff << std::endl;
+        }
+        FileManagement::crearCarpeta();
+        FileManagement::writeFastForward("datos/fast forward.dat", myNetwork);
+        return 0;
+    }
 
     //Creamos el objeto WavePropagator
     std::vector<double> dummy_sources;
@@ -69,14 +385,107 @@ int main(int argc, char** argv) {
     }
     
     //2. Escribimos la cabecera de los archivos
-    FileManagement::writeHeader(csv, wave_dat, energy_dat, num_nodes);
+    FileManagement::writeHeader(csv, wave_dat, energy_dat, num_nodes, write_frames);
 
     //3. Se escriben los estados iniciales
-    FileManagement::writeInitialState(myNetwork, propagation, csv, wave_dat, energy_dat);
+    FileManagement::writeInitialState(myNetwork, propagation, csv, wave_dat, energy_dat, write_frames);
+
+    //Las mallas 2D se dibujan como imagen, las 3D como el corte central z = d/2 y las 1D como línea
+    std::unique_ptr<FrameRenderer> renderer;
+    auto renderFrame = [&](int step, StateView A){
+        if(dimensions == 3){
+            const size_t plano = static_cast<size_t>(grid_w) * grid_h;
+            renderer->submit(step, StateView(A.data() + plano * (grid_d / 2), plano, A.step(), A.getVersion()));
+        } else {
+            renderer->submit(step, A);
+        }
+    };
+    if(render_every > 0){
+        renderer = std::make_unique<FrameRenderer>("datos/frames", dimensions >= 2 ? grid_w : num_nodes,
+                                                   dimensions >= 2 ? grid_h : 1);
+        renderFrame(0, myNetwork.getStateView());
+    }
+    if(telemetry) telemetry->setQueue(renderer.get());
+
+    //Bytes escritos en los archivos principales, leídos con tellp cada 64 pasos (cada tellp es una llamada al sistema)
+    long long bytes_contados = 0;
+    auto contarBytes = [&](){
+        const long long total = static_cast<long long>(csv.tellp()) + wave_dat.tellp() + energy_dat.tellp();
+        telemetry->addBytes(total - bytes_contados);
+        bytes_contados = total;
+    };
+
+    std::unique_ptr<SnapshotRing> ring;
+    if(shm_arg){
+        //La forma publicada es la de la red que corre: en 1D una fila de num_nodes nodos
+        try {
+            ring = std::make_unique<SnapshotRing>(shm_arg, num_nodes, 16, dimensions >= 2 ? grid_w : num_nodes,
+                                                  dimensions >= 2 ? grid_h : 1, dimensions == 3 ? grid_d : 1);
+        } catch(const std::exception& e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        ring->publish(0, myNetwork.getCurrentTime(), myNetwork.getStateView());
+    }
+
+    std::unique_ptr<SpectralAnalyzer> spectrum;
+    if(spectrum_arg){
+        spectrum = std::make_unique<SpectralAnalyzer>(num_nodes, SpectralAnalyzer::parseFrequencies(spectrum_arg),
+                                                      dt, num_steps);
+    }
+
+    std::unique_ptr<ArrivalTracker> arrivals;
+    if(arrival_arg){
+        std::vector<double> umbrales;
+        try {
+            umbrales = ArrivalTracker::parseThresholds(arrival_arg);
+        } catch(const std::exception& e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        arrivals = std::make_unique<ArrivalTracker>(num_nodes, umbrales);
+        arrivals->observeAll(myNetwork.getStateView(), 0);
+        myNetwork.setArrivalTracker(arrivals.get());
+    }
+
+    std::unique_ptr<DistributionMetrics> distribution;
+    if(dist_every > 0){
+        const char* bins_arg = flagValue(argc, argv, "-dist-bins");
+        const char* range_arg = flagValue(argc, argv, "-dist-range");
+        const char* quant_arg = flagValue(argc, argv, "-dist-quantiles");
+        std::vector<double> rango = {0.0, 0.0}, cuantiles;
+        int bins = 64;
+        try {
+            if(bins_arg){
+                bins = (isNumber(bins_arg) && std::string(bins_arg).size() <= 9) ? std::stoi(bins_arg) : 0;
+                if(bins <= 0) throw std::runtime_error(std::string("-dist-bins espera un entero positivo: ") + bins_arg);
+            }
+            if(range_arg){
+                rango = DistributionMetrics::parseList(range_arg);
+                if(rango.size() != 2 || !(rango[0] < rango[1])){
+                    throw std::runtime_error(std::string("-dist-range espera lo,hi con lo < hi: ") + range_arg);
+                }
+            }
+            cuantiles = DistributionMetrics::parseList(quant_arg ? quant_arg : "0.01,0.05,0.25,0.5,0.75,0.95,0.99");
+            for(double q : cuantiles){
+                if(q < 0.0 || q > 1.0) throw std::runtime_error("Cuantil fuera de [0, 1]: " + std::to_string(q));
+            }
+        } catch(const std::exception& e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        distribution = std::make_unique<DistributionMetrics>(bins, rango[0], rango[1], cuantiles);
+        distribution->open("datos/distribution.dat");
+        distribution->record(myNetwork.getStateView(), myNetwork.getCurrentTime());
+    }
+
+    myNetwork.setConvergenceMonitor(steady_tol > 0.0);
+    int steady_step = 0;
 
     //4. Loop principal de la simulación
     double t0 = omp_get_wtime();
     for (int step = 1; step <= num_steps; ++step) {
+        const double t_paso = omp_get_wtime();
 
         if(use_collapse){
             myNetwork.propagateWavesCollapse();// En caso de que sea 2D
@@ -86,35 +495,72 @@ int main(int argc, char** argv) {
             else                myNetwork.propagateWaves(schedule_type);
         }
 
-        propagation.calculateEnergy(1); // reduction
+        propagation.calculateEnergy(2); // reduction reproducible
 
-        std::vector<double> current_amplitudes = myNetwork.getCurrentAmplitudes();
+        // Vista de solo lectura del estado del paso (sin copiarlo), válida hasta el siguiente paso
+        const StateView current_amplitudes = myNetwork.getStateView();
 
-        // Se consigue el promedio de la amplitudes
-        double avg = 0.0;
-        for (double v : current_amplitudes) avg += v;
-        avg /= current_amplitudes.size();
+        if(spectrum) spectrum->addSample(current_amplitudes);
+        if(renderer && step % render_every == 0) renderFrame(step, current_amplitudes);
+        if(ring && step % shm_every == 0) ring->publish(step, myNetwork.getCurrentTime(), current_amplitudes);
+        if(distribution && step % dist_every == 0) distribution->record(current_amplitudes, myNetwork.getCurrentTime());
 
         // Escribir CSV + DAT (ondas y energía)
-        csv << step << "," << std::scientific << std::setprecision(6) << propagation.GetEnergy()
-            << "," << std::scientific << std::setprecision(6) << avg;
-        wave_dat << step;
-        
-        for (double amp : current_amplitudes) {
-            csv << "," << std::scientific << std::setprecision(6) << amp;
-            wave_dat << " " << std::scientific << std::setprecision(6) << amp;
+        FileManagement::writeStep(csv, wave_dat, energy_dat, step, propagation.GetEnergy(), current_amplitudes,
+                                  write_frames);
+
+        if(telemetry){
+            telemetry->recordStep(num_nodes, omp_get_wtime() - t_paso);
+            if(step % 64 == 0) contarBytes();
         }
 
-        csv << "\n";
-        wave_dat << "\n";
-        energy_dat << step << " " << std::scientific << std::setprecision(6) << propagation.GetEnergy() << "\n";
+        if(steady_tol > 0.0 && myNetwork.getLastMaxChange() < steady_tol){
+            steady_step = step;
+            break;
+        }
     }
 
     //5. Cerramos los archivos y finalizamos la simulación
     double t1 = omp_get_wtime();
     const double duracion = t1 - t0;
 
+    if(telemetry) contarBytes();
     FileManagement::finalizeSimulation(duracion, csv);
+
+    if(steady_tol > 0.0){
+        FileManagement::writeSteadyState("datos/steady state.dat", steady_tol, steady_step, myNetwork);
+        if(steady_step > 0) std::cout << "Estado estacionario en el paso " << steady_step << "." << std::endl;
+        else std::cout << "No se alcanzo el estado estacionario en " << num_steps << " pasos." << std::endl;
+    }
+
+    if(ring) ring->close();
+
+    if(renderer){
+        renderer->finish();
+        std::cout << renderer->framesWritten() << " cuadros guardados en 'datos/frames'." << std::endl;
+    }
+
+    if(telemetry){
+        telemetry->stop();
+        std::cout << "Telemetria final en '" << telemetry_arg << "'." << std::endl;
+    }
+
+    if(spectrum){
+        spectrum->write("datos/spectrum.dat");
+        std::cout << "Espectro in situ guardado en 'datos/spectrum.dat'." << std::endl;
+    }
+
+    if(distribution){
+        distribution->close();
+        std::cout << distribution->getSamples() << " resumenes de distribucion guardados en 'datos/distribution.dat'."
+                  << std::endl;
+    }
+
+    if(arrivals){
+        myNetwork.setArrivalTracker(nullptr);
+        arrivals->write("datos/arrival times.dat", dt);
+        std::cout << "Tiempos de llegada guardados en 'datos/arrival times.dat'." << std::endl;
+    }
     
     //Funciones de prueba de clausulas OpenMP
     propagation.parallelInitializationSingle();